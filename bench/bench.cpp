@@ -0,0 +1,687 @@
+#include <slic.hpp>
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// ============================================================================
+// Hardware counters
+// ============================================================================
+
+// Counted per token when passing --perf_counters, through perf_event_open on Linux only.
+// Needs kernel.perf_event_paranoid <= 2, which most distributions default to.
+namespace perf {
+    bool g_enabled = false;
+
+#if defined(__linux__)
+    struct Event {
+        char const* name;
+        uint32_t type;
+        uint64_t config;
+    };
+
+    constexpr Event Events[] = {
+        {"instructions/token", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+        {"branch-misses/token", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+        {"L1d-misses/token", PERF_TYPE_HW_CACHE,
+            PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+    };
+    constexpr size_t EventCount = std::size(Events);
+
+    /// @brief One counter per event of this thread in user space, -1 for events the machine lacks.
+    class Counters {
+    public:
+        static Counters& instance() {
+            static Counters counters;
+            return counters;
+        }
+
+        [[nodiscard]] bool any() const {
+            return std::any_of(std::begin(m_fds), std::end(m_fds), [](int fd) { return fd >= 0; });
+        }
+        [[nodiscard]] bool has(size_t event) const { return m_fds[event] >= 0; }
+
+        void start() {
+            for (int fd : m_fds) {
+                if (fd < 0) continue;
+                ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+                ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+            }
+        }
+
+        std::array<uint64_t, EventCount> stop() {
+            std::array<uint64_t, EventCount> values{};
+            for (size_t i = 0; i < EventCount; ++i) {
+                if (m_fds[i] < 0) continue;
+                ioctl(m_fds[i], PERF_EVENT_IOC_DISABLE, 0);
+                if (read(m_fds[i], &values[i], sizeof(values[i])) != sizeof(values[i])) values[i] = 0;
+            }
+            return values;
+        }
+
+    private:
+        Counters() {
+            for (size_t i = 0; i < EventCount; ++i) {
+                perf_event_attr attr{};
+                attr.size = sizeof(attr);
+                attr.type = Events[i].type;
+                attr.config = Events[i].config;
+                attr.disabled = 1;
+                attr.exclude_kernel = 1;
+                attr.exclude_hv = 1;
+                m_fds[i] = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+            }
+        }
+
+        ~Counters() {
+            for (int fd : m_fds) {
+                if (fd >= 0) close(fd);
+            }
+        }
+
+        int m_fds[EventCount];
+    };
+#else
+    struct Event {
+        char const* name;
+    };
+
+    constexpr Event Events[] = {{"instructions/token"}, {"branch-misses/token"}, {"L1d-misses/token"}};
+    constexpr size_t EventCount = std::size(Events);
+
+    class Counters {
+    public:
+        static Counters& instance() {
+            static Counters counters;
+            return counters;
+        }
+
+        [[nodiscard]] bool any() const { return false; }
+        [[nodiscard]] bool has(size_t) const { return false; }
+        void start() {}
+        std::array<uint64_t, EventCount> stop() { return {}; }
+    };
+#endif
+
+    /// @brief Counts the events of a benchmark loop and reports them per token alongside "tokens".
+    class Region {
+    public:
+        explicit Region(benchmark::State& state) : m_state(state) {
+            if (g_enabled) Counters::instance().start();
+        }
+
+        void report(size_t tokens) {
+            m_state.counters["tokens"] = static_cast<double>(tokens);
+            if (!g_enabled) return;
+
+            auto& counters = Counters::instance();
+            auto values = counters.stop();
+            double total = static_cast<double>(m_state.iterations()) * static_cast<double>(tokens);
+            for (size_t i = 0; i < EventCount && total > 0; ++i) {
+                if (counters.has(i)) m_state.counters[Events[i].name] = static_cast<double>(values[i]) / total;
+            }
+        }
+
+    private:
+        benchmark::State& m_state;
+    };
+} // namespace perf
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+static std::vector<char const*> toArgv(std::vector<std::string> const& args) {
+    std::vector<char const*> argv;
+    argv.reserve(args.size());
+    for (auto const& arg : args) argv.push_back(arg.c_str());
+    return argv;
+}
+
+// tokens defaults to the arguments after the program name
+template <typename T, template <class...> class Parser = slic::ArgParser>
+static void runParser(benchmark::State& state, std::vector<char const*> const& argv, size_t tokens = 0) {
+    perf::Region region(state);
+    for (auto _ : state) {
+        Parser<T> parser(static_cast<int>(argv.size()), argv.data());
+        auto result = parser.parse();
+        benchmark::DoNotOptimize(result);
+        benchmark::DoNotOptimize(parser.result());
+    }
+    region.report(tokens ? tokens : argv.size() - 1);
+}
+
+// ============================================================================
+// Synthetic option sets
+// ============================================================================
+
+namespace synthetic {
+    template <size_t I>
+    struct Name {
+        static constexpr auto Buffer = [] {
+            std::array<char, 16> buf{'-', '-', 'o', 'p', 't'};
+            size_t len = 5;
+            char digits[8]{};
+            size_t count = 0;
+            size_t value = I;
+            do {
+                digits[count++] = static_cast<char>('0' + value % 10);
+                value /= 10;
+            } while (value);
+            while (count) buf[len++] = digits[--count];
+            return buf;
+        }();
+        static constexpr std::string_view value{Buffer.data()};
+    };
+
+    template <size_t I>
+    struct Field { int value = 0; };
+
+    template <typename Seq>
+    struct Fields;
+
+    template <size_t... I>
+    struct Fields<std::index_sequence<I...>> : Field<I>... {};
+
+    /// @brief Options struct with N integer options named --opt0 .. --opt{N-1}.
+    template <size_t N>
+    struct Flat : Fields<std::make_index_sequence<N>> {
+        using Base = Fields<std::make_index_sequence<N>>;
+
+        static constexpr auto Options = []<size_t... I>(std::index_sequence<I...>) {
+            return std::make_tuple(slic::Option<int, Base>{Name<I>::value, &Field<I>::value}...);
+        }(std::make_index_sequence<N>());
+    };
+
+    /// @brief Builds an argv setting `used` options spread evenly over the N declared ones.
+    template <size_t N>
+    std::vector<std::string> makeArgs(size_t used) {
+        std::vector<std::string> args{"program"};
+        for (size_t i = 0; i < used; ++i) {
+            args.push_back("--opt" + std::to_string((N - 1) - i * (N / used)));
+            args.push_back(std::to_string(i));
+        }
+        return args;
+    }
+
+    /// @brief Positional-heavy struct: a few named slots followed by a VarArgs tail.
+    struct Files {
+        bool verbose = false;
+        std::string_view first;
+        std::optional<std::string_view> second;
+        slic::ArgSpan rest;
+
+        static constexpr std::tuple Options = {
+            slic::Option{"--verbose", "-v", &Files::verbose},
+            slic::Arg{"FIRST", &Files::first},
+            slic::Arg{"SECOND", &Files::second},
+            slic::VarArgs{&Files::rest}
+        };
+    };
+
+    /// @brief Numbers after "--", converted on demand.
+    struct Numbers {
+        slic::TypedArgSpan<int> values;
+
+        static constexpr std::tuple Options = {
+            slic::VarArgs{&Numbers::values}
+        };
+    };
+
+    std::vector<std::string> makeNumbers(size_t count) {
+        std::vector<std::string> args{"program", "--"};
+        for (size_t i = 0; i < count; ++i) {
+            args.push_back(std::to_string(i * 7919 % 1'000'003));
+        }
+        return args;
+    }
+
+    template <size_t N>
+    struct FlatWithCompletion : Flat<N> {
+        static constexpr bool Completion = true;
+    };
+
+    struct FilesPermuted : Files {
+        static constexpr bool Permute = true;
+    };
+
+    struct FilesWithResponse : Files {
+        static constexpr bool ResponseFiles = true;
+    };
+
+    template <size_t N>
+    struct FlatWithConfig : Flat<N> {
+        static constexpr bool ConfigFiles = true;
+    };
+
+    std::vector<std::string> makeFiles(size_t count, bool separator) {
+        std::vector<std::string> args{"program", "-v"};
+        if (separator) args.emplace_back("--");
+        for (size_t i = 0; i < count; ++i) {
+            args.push_back("file" + std::to_string(i) + ".txt");
+        }
+        return args;
+    }
+} // namespace synthetic
+
+// ============================================================================
+// README cases
+// ============================================================================
+
+struct BenchArgs {
+    bool verbose = false;
+    bool debug = false;
+    int count = 0;
+    int level = 0;
+    int threads = 0;
+    int timeout = 0;
+    int retry = 0;
+    std::string_view name;
+    std::string_view output;
+    std::string_view input;
+    std::optional<std::string_view> input2;
+
+    static constexpr std::tuple Options = {
+        slic::Option{"--verbose", "-v", &BenchArgs::verbose},
+        slic::Option{"--debug", "-d", &BenchArgs::debug},
+        slic::Option{"--count", "-c", &BenchArgs::count},
+        slic::Option{"--level", "-l", &BenchArgs::level},
+        slic::Option{"--threads", "-t", &BenchArgs::threads},
+        slic::Option{"--timeout", &BenchArgs::timeout},
+        slic::Option{"--retry", "-r", &BenchArgs::retry},
+        slic::Option{"--name", "-n", &BenchArgs::name},
+        slic::Option{"--output", "-o", &BenchArgs::output},
+        slic::Arg{"INPUT", &BenchArgs::input},
+        slic::Arg{"INPUT2", &BenchArgs::input2}
+    };
+};
+
+static void BM_Simple(benchmark::State& state) {
+    runParser<BenchArgs>(state, {"program", "-v", "--count", "42", "myfile.txt"});
+}
+BENCHMARK(BM_Simple);
+
+static void BM_Medium(benchmark::State& state) {
+    runParser<BenchArgs>(state, {
+        "program", "-v", "--count", "42", "--name", "test", "--level", "3",
+        "--output", "out.txt", "input.txt"
+    });
+}
+BENCHMARK(BM_Medium);
+
+static void BM_Complex(benchmark::State& state) {
+    runParser<BenchArgs>(state, {
+        "program", "-v", "--count", "42", "--name", "test", "--level", "3",
+        "--output", "out.txt", "--debug", "--threads", "8", "--timeout", "1000",
+        "--retry", "3", "input1.txt", "input2.txt"
+    });
+}
+BENCHMARK(BM_Complex);
+
+struct ConstrainedBenchArgs : BenchArgs {
+    static constexpr std::tuple Options = {
+        slic::Option{"--verbose", "-v", &ConstrainedBenchArgs::verbose},
+        slic::Option{"--debug", "-d", &ConstrainedBenchArgs::debug},
+        slic::Option{"--count", "-c", &ConstrainedBenchArgs::count}.range(0, 100),
+        slic::Option{"--level", "-l", &ConstrainedBenchArgs::level}.oneOf({1, 2, 3}),
+        slic::Option{"--threads", "-t", &ConstrainedBenchArgs::threads}.range(1, 256),
+        slic::Option{"--timeout", &ConstrainedBenchArgs::timeout}.min(1),
+        slic::Option{"--retry", "-r", &ConstrainedBenchArgs::retry}.max(10),
+        slic::Option{"--name", "-n", &ConstrainedBenchArgs::name}.nonEmpty(),
+        slic::Option{"--output", "-o", &ConstrainedBenchArgs::output}.nonEmpty(),
+        slic::Arg{"INPUT", &ConstrainedBenchArgs::input}.nonEmpty(),
+        slic::Arg{"INPUT2", &ConstrainedBenchArgs::input2}
+    };
+};
+
+// same command line as BM_Complex, with every value checked against its constraints
+static void BM_Constrained(benchmark::State& state) {
+    runParser<ConstrainedBenchArgs>(state, {
+        "program", "-v", "--count", "42", "--name", "test", "--level", "3",
+        "--output", "out.txt", "--debug", "--threads", "8", "--timeout", "1000",
+        "--retry", "3", "input1.txt", "input2.txt"
+    });
+}
+BENCHMARK(BM_Constrained);
+
+static void BM_CompactComplex(benchmark::State& state) {
+    runParser<BenchArgs, slic::CompactArgParser>(state, {
+        "program", "-v", "--count", "42", "--name", "test", "--level", "3",
+        "--output", "out.txt", "--debug", "--threads", "8", "--timeout", "1000",
+        "--retry", "3", "input1.txt", "input2.txt"
+    });
+}
+BENCHMARK(BM_CompactComplex);
+
+static void BM_UnknownOption(benchmark::State& state) {
+    runParser<BenchArgs>(state, {"program", "-v", "--count", "42", "--lavel", "3", "input1.txt"});
+}
+BENCHMARK(BM_UnknownOption);
+
+static void BM_Suggestions(benchmark::State& state) {
+    char const* argv[] = {"program", "-v", "--count", "42", "--lavel", "3", "input1.txt"};
+    slic::ArgParser<BenchArgs> parser(7, argv);
+    auto result = parser.parse();
+    for (auto _ : state) {
+        auto similar = result.suggestions();
+        benchmark::DoNotOptimize(similar);
+    }
+}
+BENCHMARK(BM_Suggestions);
+
+static void BM_ConfigRead(benchmark::State& state) {
+    static slic::ConfigHandle<BenchArgs> config;
+    if (state.thread_index() == 0) {
+        char const* argv[] = {"program", "-v", "--count", "42", "input1.txt"};
+        (void) config.reload(argv);
+    }
+    for (auto _ : state) {
+        auto snapshot = config.read();
+        benchmark::DoNotOptimize(snapshot->count);
+    }
+}
+BENCHMARK(BM_ConfigRead)->Threads(1)->Threads(8);
+
+static void BM_ComplexReused(benchmark::State& state) {
+    std::vector<char const*> argv = {
+        "program", "-v", "--count", "42", "--name", "test", "--level", "3",
+        "--output", "out.txt", "--debug", "--threads", "8", "--timeout", "1000",
+        "--retry", "3", "input1.txt", "input2.txt"
+    };
+    slic::ArgParser<BenchArgs> parser;
+    for (auto _ : state) {
+        auto result = parser.parse(argv);
+        benchmark::DoNotOptimize(result);
+        benchmark::DoNotOptimize(parser.result());
+    }
+}
+BENCHMARK(BM_ComplexReused);
+
+static void BM_ParseBatch(benchmark::State& state) {
+    std::vector<char const*> argv = {"program", "-v", "--count", "42", "--name", "test", "myfile.txt"};
+    std::vector<std::span<char const* const>> inputs(static_cast<size_t>(state.range(0)), argv);
+    std::vector<BenchArgs> outputs(inputs.size());
+    std::vector<slic::ParseResult> results(inputs.size());
+
+    slic::ArgParser<BenchArgs> parser;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(parser.parseBatch(inputs, outputs, results));
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ParseBatch)->Arg(10'000);
+
+struct FlagsArgs {
+    bool a = false, b = false, c = false, d = false;
+    bool e = false, f = false, g = false, h = false;
+
+    static constexpr std::tuple Options = {
+        slic::Option{"--alpha", "-a", &FlagsArgs::a},
+        slic::Option{"--bravo", "-b", &FlagsArgs::b},
+        slic::Option{"--charlie", "-c", &FlagsArgs::c},
+        slic::Option{"--delta", "-d", &FlagsArgs::d},
+        slic::Option{"--echo", "-e", &FlagsArgs::e},
+        slic::Option{"--foxtrot", "-f", &FlagsArgs::f},
+        slic::Option{"--golf", "-g", &FlagsArgs::g},
+        slic::Option{"--hotel", "-h", &FlagsArgs::h}
+    };
+};
+
+static void BM_FlagsOnly(benchmark::State& state) {
+    runParser<FlagsArgs>(state, {"program", "-a", "-b", "-c", "-d", "-e", "-f", "-g", "-h"});
+}
+BENCHMARK(BM_FlagsOnly);
+
+static void BM_FlagsOnlyClustered(benchmark::State& state) {
+    runParser<FlagsArgs>(state, {"program", "-abcdefgh"});
+}
+BENCHMARK(BM_FlagsOnlyClustered);
+
+// ============================================================================
+// Synthetic cases
+// ============================================================================
+
+template <size_t N>
+static void BM_OptionLookup(benchmark::State& state) {
+    runParser<synthetic::Flat<N>>(state, toArgv(synthetic::makeArgs<N>(8)));
+}
+BENCHMARK_TEMPLATE(BM_OptionLookup, 8);
+BENCHMARK_TEMPLATE(BM_OptionLookup, 16);
+BENCHMARK_TEMPLATE(BM_OptionLookup, 32);
+BENCHMARK_TEMPLATE(BM_OptionLookup, 64);
+BENCHMARK_TEMPLATE(BM_OptionLookup, 128);
+BENCHMARK_TEMPLATE(BM_OptionLookup, 256);
+
+static void BM_LargeArgv(benchmark::State& state) {
+    std::vector<std::string> args{"program"};
+    for (int64_t i = 0; i < state.range(0); ++i) {
+        args.push_back("--opt" + std::to_string(i % 64) + "=" + std::to_string(i));
+    }
+    runParser<synthetic::Flat<64>>(state, toArgv(args));
+}
+BENCHMARK(BM_LargeArgv)->Arg(100'000)->Unit(benchmark::kMicrosecond);
+
+static void BM_HundredOptions(benchmark::State& state) {
+    runParser<synthetic::Flat<100>>(state, toArgv(synthetic::makeArgs<100>(100)));
+}
+BENCHMARK(BM_HundredOptions);
+
+static void BM_CompactHundredOptions(benchmark::State& state) {
+    runParser<synthetic::Flat<100>, slic::CompactArgParser>(state, toArgv(synthetic::makeArgs<100>(100)));
+}
+BENCHMARK(BM_CompactHundredOptions);
+
+struct NullSink {
+    void write(std::string_view text) const noexcept { benchmark::DoNotOptimize(text.data()); }
+};
+
+// what `tool --complete --opt4` does for a 256-option tool (11 matches), minus process startup
+static void BM_Complete(benchmark::State& state) {
+    std::array<std::string_view, 1> words{"--opt4"};
+    for (auto _ : state) {
+        slic::ArgParser<synthetic::FlatWithCompletion<256>>::writeCompletions(slic::ArgSpan{std::span(words)}, NullSink{});
+    }
+}
+BENCHMARK(BM_Complete);
+
+static void BM_Positionals(benchmark::State& state) {
+    auto args = synthetic::makeFiles(static_cast<size_t>(state.range(0)), false);
+    runParser<synthetic::Files>(state, toArgv(args));
+}
+BENCHMARK(BM_Positionals)->Arg(10'000);
+
+static void BM_VarArgsTail(benchmark::State& state) {
+    auto args = synthetic::makeFiles(static_cast<size_t>(state.range(0)), true);
+    runParser<synthetic::Files>(state, toArgv(args));
+}
+BENCHMARK(BM_VarArgsTail)->Range(1'000, 1'000'000);
+
+// every other file is followed by -v, the fully interleaved worst case where every token is moved once
+// per merge level (n log n); the copy restores the original order each iteration and costs a memcpy
+// of the pointers
+static void BM_Permute(benchmark::State& state) {
+    auto count = static_cast<size_t>(state.range(0));
+    std::vector<std::string> args{"program"};
+    for (size_t i = 0; i < count; ++i) {
+        args.push_back("file" + std::to_string(i) + ".txt");
+        if (i % 2) args.emplace_back("-v");
+    }
+    auto original = toArgv(args);
+    auto argv = original;
+    perf::Region region(state);
+    for (auto _ : state) {
+        std::copy(original.begin(), original.end(), argv.begin());
+        slic::ArgParser<synthetic::FilesPermuted> parser(static_cast<int>(argv.size()), argv.data());
+        auto result = parser.parse();
+        benchmark::DoNotOptimize(result);
+        benchmark::DoNotOptimize(parser.result());
+    }
+    region.report(argv.size() - 1);
+    state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_Permute)->RangeMultiplier(10)->Range(1'000, 1'000'000)->Unit(benchmark::kMicrosecond)->Complexity();
+
+// state.range(1) threads, 0 for the sequential overload
+static void BM_ConvertInto(benchmark::State& state) {
+    auto args = synthetic::makeNumbers(static_cast<size_t>(state.range(0)));
+    auto argv = toArgv(args);
+    auto threads = static_cast<size_t>(state.range(1));
+
+    slic::ArgParser<synthetic::Numbers> parser(static_cast<int>(argv.size()), argv.data());
+    (void) parser.parse();
+    auto const& values = parser.result().values;
+    std::vector<int> out(values.size());
+    for (auto _ : state) {
+        auto result = threads ? values.convertInto<std::thread>(out, threads) : values.convertInto(out);
+        benchmark::DoNotOptimize(result);
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.counters["values"] = static_cast<double>(values.size());
+}
+BENCHMARK(BM_ConvertInto)->Args({1'000'000, 0})->Args({1'000'000, 2})->Args({1'000'000, 8})
+    ->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// time until the first leftover positional is available, compare with BM_VarArgsTail
+static void BM_PositionalsFirst(benchmark::State& state) {
+    auto args = synthetic::makeFiles(static_cast<size_t>(state.range(0)), false);
+    auto argv = toArgv(args);
+    for (auto _ : state) {
+        slic::ArgParser<synthetic::Files> parser(static_cast<int>(argv.size()), argv.data());
+        auto positionals = parser.positionals();
+        benchmark::DoNotOptimize(*positionals.begin());
+    }
+}
+BENCHMARK(BM_PositionalsFirst)->Range(1'000, 1'000'000);
+
+static void BM_PositionalsAll(benchmark::State& state) {
+    auto args = synthetic::makeFiles(static_cast<size_t>(state.range(0)), false);
+    auto argv = toArgv(args);
+    perf::Region region(state);
+    for (auto _ : state) {
+        slic::ArgParser<synthetic::Files> parser(static_cast<int>(argv.size()), argv.data());
+        auto positionals = parser.positionals();
+        for (std::string_view value : positionals) {
+            benchmark::DoNotOptimize(value);
+        }
+        benchmark::DoNotOptimize(positionals.result());
+    }
+    region.report(argv.size() - 1);
+}
+BENCHMARK(BM_PositionalsAll)->Range(1'000, 1'000'000);
+
+static void BM_ParseString(benchmark::State& state) {
+    std::string_view line =
+        "program -v --count 42 --name 'test run' --level 3 --output out\\ dir/out.txt --debug "
+        "--threads 8 --timeout 1000 --retry 3 /some/long/path/to/input1.txt /another/path/input2.txt";
+    std::vector<std::string_view> tokens(32);
+    std::vector<char> scratch(line.size());
+    slic::Tokenizer tokenizer(tokens, scratch);
+
+    slic::ArgParser<BenchArgs> parser;
+    for (auto _ : state) {
+        auto result = parser.parseString(line, tokenizer);
+        benchmark::DoNotOptimize(result);
+        benchmark::DoNotOptimize(parser.result());
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(line.size()));
+}
+BENCHMARK(BM_ParseString);
+
+static void BM_Tokenize(benchmark::State& state) {
+    std::string line;
+    for (int i = 0; line.size() < static_cast<size_t>(state.range(0)); ++i) {
+        line += i % 8 == 0 ? "\"quoted path/file" + std::to_string(i) + ".txt\" " : "/usr/local/lib/file" + std::to_string(i) + ".o ";
+    }
+    std::vector<std::string_view> tokens(line.size() / 2);
+    std::vector<char> scratch(line.size());
+    slic::Tokenizer tokenizer(tokens, scratch);
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(tokenizer.tokenize(line));
+        benchmark::DoNotOptimize(tokenizer.tokens());
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(line.size()));
+}
+BENCHMARK(BM_Tokenize)->Arg(1 << 16);
+
+static void BM_ResponseFile(benchmark::State& state) {
+    auto count = static_cast<size_t>(state.range(0));
+    auto path = std::filesystem::temp_directory_path() / ("slic_bench_" + std::to_string(count) + ".rsp");
+
+    std::FILE* file = std::fopen(path.string().c_str(), "wb");
+    for (size_t i = 0; i < count; ++i) {
+        std::fprintf(file, "file%zu.txt\n", i);
+    }
+    std::fclose(file);
+
+    std::string arg = "@" + path.string();
+    runParser<synthetic::FilesWithResponse>(state, {"program", "-v", arg.c_str()}, count);
+
+    std::filesystem::remove(path);
+}
+BENCHMARK(BM_ResponseFile)->Arg(1'000)->Arg(1'000'000)->Unit(benchmark::kMillisecond);
+
+static void BM_ConfigFile(benchmark::State& state) {
+    constexpr size_t Options = 256;
+    auto lines = static_cast<size_t>(state.range(0));
+    auto path = std::filesystem::temp_directory_path() / ("slic_bench_" + std::to_string(lines) + ".conf");
+
+    std::FILE* file = std::fopen(path.string().c_str(), "wb");
+    std::fprintf(file, "# generated\n");
+    for (size_t i = 0; i < lines; ++i) {
+        std::fprintf(file, "opt%zu = %zu\n", (i * 7) % Options, i);
+    }
+    std::fclose(file);
+
+    std::string config = path.string();
+    char const* argv[] = {"program", "--opt0", "1"};
+    char const* const envp[] = {nullptr};
+    for (auto _ : state) {
+        slic::ArgParser<synthetic::FlatWithConfig<Options>> parser(3, argv);
+        auto result = parser.parseWithConfig(config.c_str(), envp);
+        benchmark::DoNotOptimize(result);
+        benchmark::DoNotOptimize(parser.result());
+    }
+    state.counters["lines"] = static_cast<double>(lines);
+
+    std::filesystem::remove(path);
+}
+BENCHMARK(BM_ConfigFile)->Arg(1'000)->Arg(100'000)->Unit(benchmark::kMicrosecond);
+
+// BENCHMARK_MAIN(), plus --perf_counters
+int main(int argc, char** argv) {
+    std::vector<char*> args;
+    for (int i = 0; i < argc; ++i) {
+        if (std::string_view(argv[i]) == "--perf_counters") {
+            perf::g_enabled = true;
+        } else {
+            args.push_back(argv[i]);
+        }
+    }
+    if (perf::g_enabled && !perf::Counters::instance().any()) {
+        std::fprintf(stderr, "--perf_counters: perf_event_open failed, check kernel.perf_event_paranoid\n");
+        perf::g_enabled = false;
+    }
+
+    int count = static_cast<int>(args.size());
+    args.push_back(nullptr);
+    benchmark::Initialize(&count, args.data());
+    if (benchmark::ReportUnrecognizedArguments(count, args.data())) {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,115 @@
+// Compiler launcher for the compile-time benchmarks: runs the command after "--" and writes
+// "<wall seconds>;<peak memory KB>" to the given file.
+//
+//   slic_measure <result file> -- <compiler> <args...>
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#if defined(_WIN32)
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    struct Measurement {
+        int exitCode = 1;
+        double seconds = 0;
+        long long peakKb = 0;
+    };
+
+#if defined(_WIN32)
+    std::string quote(char const* arg) {
+        std::string out = "\"";
+        for (char const* c = arg; *c; ++c) {
+            if (*c == '"') out += '\\';
+            out += *c;
+        }
+        return out + '"';
+    }
+
+    Measurement run(char** argv) {
+        std::string commandLine;
+        for (char** arg = argv; *arg; ++arg) {
+            if (!commandLine.empty()) commandLine += ' ';
+            commandLine += quote(*arg);
+        }
+
+        Measurement result;
+        STARTUPINFOA startup{};
+        startup.cb = sizeof(startup);
+        PROCESS_INFORMATION process{};
+        auto start = std::chrono::steady_clock::now();
+        if (!CreateProcessA(nullptr, commandLine.data(), nullptr, nullptr, TRUE, 0, nullptr, nullptr, &startup, &process)) {
+            std::fprintf(stderr, "slic_measure: cannot run %s\n", argv[0]);
+            return result;
+        }
+        WaitForSingleObject(process.hProcess, INFINITE);
+        result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        DWORD code = 1;
+        GetExitCodeProcess(process.hProcess, &code);
+        result.exitCode = static_cast<int>(code);
+
+        PROCESS_MEMORY_COUNTERS memory{};
+        if (GetProcessMemoryInfo(process.hProcess, &memory, sizeof(memory))) {
+            result.peakKb = static_cast<long long>(memory.PeakWorkingSetSize / 1024);
+        }
+        CloseHandle(process.hThread);
+        CloseHandle(process.hProcess);
+        return result;
+    }
+#else
+    Measurement run(char** argv) {
+        Measurement result;
+        auto start = std::chrono::steady_clock::now();
+        pid_t pid = fork();
+        if (pid < 0) {
+            std::perror("slic_measure: fork");
+            return result;
+        }
+        if (pid == 0) {
+            execvp(argv[0], argv);
+            std::perror("slic_measure: exec");
+            _exit(127);
+        }
+
+        int status = 0;
+        rusage usage{};
+        if (wait4(pid, &status, 0, &usage) < 0) {
+            std::perror("slic_measure: wait");
+            return result;
+        }
+        result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        result.exitCode = WIFEXITED(status) ? WEXITSTATUS(status) : 1;
+    #if defined(__APPLE__)
+        result.peakKb = static_cast<long long>(usage.ru_maxrss / 1024); // bytes on macOS
+    #else
+        result.peakKb = static_cast<long long>(usage.ru_maxrss);
+    #endif
+        return result;
+    }
+#endif
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 4 || std::strcmp(argv[2], "--") != 0) {
+        std::fprintf(stderr, "usage: slic_measure <result file> -- <command> [args...]\n");
+        return 2;
+    }
+
+    Measurement result = run(argv + 3);
+    if (result.exitCode == 0) {
+        if (FILE* out = std::fopen(argv[1], "w")) {
+            std::fprintf(out, "%.3f;%lld\n", result.seconds, result.peakKb);
+            std::fclose(out);
+        }
+    }
+    return result.exitCode;
+}
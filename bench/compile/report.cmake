@@ -0,0 +1,66 @@
+# Prints the compile-time benchmark results as a markdown table, followed by the runtime
+# results of slic_bench when RUNTIME names its JSON output.
+#
+#   cmake -DRESULTS=<dir> -DCOMPILER=<id-version> [-DRUNTIME=<slic_bench.json>] -P report.cmake
+
+function(read_result file out)
+    set(value "-")
+    if (EXISTS ${file})
+        file(READ ${file} value)
+        string(STRIP "${value}" value)
+    endif()
+    set(${out} "${value}" PARENT_SCOPE)
+endfunction()
+
+file(GLOB sizes ${RESULTS}/*.size)
+set(rows "")
+foreach (file IN LISTS sizes)
+    get_filename_component(label ${file} NAME_WE)
+    string(REGEX MATCH "^(.*)_([0-9]+)$" _ ${label})
+    set(parser ${CMAKE_MATCH_1})
+    set(count ${CMAKE_MATCH_2})
+
+    read_result(${RESULTS}/${label}.compile compile)
+    set(seconds "-")
+    set(peak "-")
+    if (NOT compile STREQUAL "-")
+        list(GET compile 0 seconds)
+        list(GET compile 1 peak)
+        math(EXPR peak "${peak} / 1024")
+    endif()
+    read_result(${file} size)
+
+    # zero-padded count first, so that rows sort by option count
+    string(LENGTH ${count} digits)
+    math(EXPR padding "6 - ${digits}")
+    string(REPEAT "0" ${padding} zeros)
+    list(APPEND rows "${zeros}${count}|| ${parser} | ${count} | ${seconds} | ${peak} | ${size} |")
+endforeach()
+list(SORT rows)
+
+set(report "\nCompile-time benchmarks (${COMPILER})\n\n")
+string(APPEND report "| Parser | Options | Compile (s) | Peak memory (MB) | Stripped size (bytes) |\n")
+string(APPEND report "|--------|---------|-------------|------------------|-----------------------|\n")
+foreach (row IN LISTS rows)
+    string(REGEX REPLACE "^[0-9]+\\|" "" row "${row}")
+    string(APPEND report "${row}\n")
+endforeach()
+
+if (RUNTIME AND EXISTS ${RUNTIME})
+    file(READ ${RUNTIME} json)
+    string(JSON count LENGTH "${json}" benchmarks)
+    string(APPEND report "\nRuntime benchmarks (slic_bench)\n\n")
+    string(APPEND report "| Benchmark | Time | CPU |\n|-----------|------|-----|\n")
+    math(EXPR last "${count} - 1")
+    foreach (i RANGE ${last})
+        string(JSON name GET "${json}" benchmarks ${i} name)
+        string(JSON real GET "${json}" benchmarks ${i} real_time)
+        string(JSON cpu GET "${json}" benchmarks ${i} cpu_time)
+        string(JSON unit GET "${json}" benchmarks ${i} time_unit)
+        string(REGEX REPLACE "(\\.[0-9])[0-9]*$" "\\1" real "${real}")
+        string(REGEX REPLACE "(\\.[0-9])[0-9]*$" "\\1" cpu "${cpu}")
+        string(APPEND report "| ${name} | ${real} ${unit} | ${cpu} ${unit} |\n")
+    endforeach()
+endif()
+
+message("${report}")
@@ -0,0 +1,20 @@
+# Records the stripped size of BINARY in OUTPUT. Without a strip tool (MSVC), the executable
+# is measured as is, its debug info lives in the PDB.
+#
+#   cmake -DBINARY=<exe> -DSTRIP=<strip or empty> -DOUTPUT=<file> -P size.cmake
+
+set(measured ${BINARY})
+if (STRIP)
+    set(measured ${OUTPUT}.stripped)
+    file(COPY_FILE ${BINARY} ${measured})
+    execute_process(COMMAND ${STRIP} ${measured} RESULT_VARIABLE failed)
+    if (failed)
+        message(FATAL_ERROR "Cannot strip ${BINARY}")
+    endif()
+endif()
+
+file(SIZE ${measured} size)
+file(WRITE ${OUTPUT} "${size}\n")
+if (STRIP)
+    file(REMOVE ${measured})
+endif()
@@ -0,0 +1,319 @@
+// Fuzz target for ArgParser::parse() on untrusted argv.
+//
+// The first byte of an input picks one of the option structs below, the rest is split at '\n'
+// into the arguments after the program name. Corpus files start with '0' to '7', which select
+// target 0 to 7. Besides not crashing, the parsers must agree with each other and report an
+// argIndex inside argv.
+
+#include <slic.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+namespace {
+    enum class Level { Low, Mid, High };
+}
+
+template <>
+struct slic::EnumTraits<Level> {
+    static constexpr std::array Names = {
+        std::pair{"low", Level::Low},
+        std::pair{"mid", Level::Mid},
+        std::pair{"high", Level::High}
+    };
+};
+
+namespace {
+    /// @brief Aborts so the fuzzer records the input, also in builds without assertions.
+    void check(bool condition) {
+        if (!condition) std::abort();
+    }
+
+    // one field of every scalar type, enums and optional positionals
+    struct Scalars {
+        bool verbose = false;
+        int count = 0;
+        unsigned size = 0;
+        long long offset = 0;
+        float scale = 1;
+        double ratio = 0;
+        std::optional<int> level;
+        Level mode = Level::Low;
+        std::string_view name;
+        std::string_view input;
+        std::optional<std::string_view> output;
+
+        static constexpr auto Options = std::make_tuple(
+            slic::Option{"--verbose", "-v", &Scalars::verbose},
+            slic::Option{"--count", "-c", &Scalars::count},
+            slic::Option{"--size", "-s", &Scalars::size},
+            slic::Option{"--offset", &Scalars::offset},
+            slic::Option{"--scale", &Scalars::scale},
+            slic::Option{"--ratio", "-r", &Scalars::ratio},
+            slic::Option{"--level", "-l", &Scalars::level},
+            slic::Option{"--mode", "-m", &Scalars::mode},
+            slic::Option{"--name", "-n", &Scalars::name},
+            slic::Arg{"input", &Scalars::input},
+            slic::Arg{"output", &Scalars::output}
+        );
+    };
+
+    // repeated options, abbreviated long names and short clusters
+    struct Repeated {
+        bool all = false;
+        bool brief = false;
+        slic::Collect<std::string_view, 3> includes;
+        slic::Collect<int, 2> jobs;
+        slic::CollectViews<double, 4> weights;
+        slic::Collect<Level, 2> levels;
+
+        static constexpr bool Abbreviations = true;
+        static constexpr auto Options = std::make_tuple(
+            slic::Option{"--all", "-a", &Repeated::all},
+            slic::Option{"--brief", "-b", &Repeated::brief},
+            slic::Option{"--include", "-I", &Repeated::includes},
+            slic::Option{"--jobs", "-j", &Repeated::jobs},
+            slic::Option{"--weight", "-w", &Repeated::weights},
+            slic::Option{"--level", &Repeated::levels}
+        );
+    };
+
+    // required options, constraints and values from a fixed environment
+    struct Checked {
+        std::string_view cluster;
+        int threads = 4;
+        std::string_view format = "json";
+        unsigned port = 80;
+        bool dryRun = false;
+
+        static constexpr auto Options = std::make_tuple(
+            slic::Option{"--cluster", "-c", &Checked::cluster}.required().nonEmpty(),
+            slic::Option{"--threads", "-t", &Checked::threads}.range(1, 256).env("FUZZ_THREADS"),
+            slic::Option{"--format", &Checked::format}.oneOf({"json", "yaml"}).env("FUZZ_FORMAT"),
+            slic::Option{"--dry-run", &Checked::dryRun}.env("FUZZ_DRY_RUN"),
+            slic::Arg{"port", &Checked::port}.max(65535u)
+        );
+    };
+
+    struct Add {
+        bool force = false;
+        std::string_view path;
+
+        static constexpr auto Options = std::make_tuple(
+            slic::Option{"--force", "-f", &Add::force},
+            slic::Arg{"path", &Add::path}
+        );
+    };
+
+    struct Commit {
+        std::string_view message;
+        slic::ArgSpan files;
+
+        static constexpr auto Options = std::make_tuple(
+            slic::Option{"--message", "-m", &Commit::message},
+            slic::VarArgs{&Commit::files}
+        );
+    };
+
+    struct Git {
+        bool verbose = false;
+        std::variant<std::monostate, Add, Commit> command;
+
+        static constexpr auto Options = std::make_tuple(
+            slic::Option{"--verbose", "-v", &Git::verbose},
+            slic::Subcommands{&Git::command,
+                slic::Command<Add>{"add"},
+                slic::Command<Commit>{"commit"}}
+        );
+    };
+
+    struct Permuted {
+        bool verbose = false;
+        int count = 0;
+        std::string_view input;
+        slic::ArgSpan rest;
+
+        static constexpr bool Permute = true;
+        static constexpr auto Options = std::make_tuple(
+            slic::Option{"--verbose", "-v", &Permuted::verbose},
+            slic::Option{"--count", "-c", &Permuted::count},
+            slic::Arg{"input", &Permuted::input},
+            slic::VarArgs{&Permuted::rest}
+        );
+    };
+
+    struct Numbers {
+        bool sum = false;
+        std::string_view op;
+        slic::TypedArgSpan<int> values;
+
+        static constexpr auto Options = std::make_tuple(
+            slic::Option{"--sum", &Numbers::sum},
+            slic::Arg{"op", &Numbers::op},
+            slic::VarArgs{&Numbers::values}
+        );
+    };
+
+    // the subset both backends support, parsed with each and compared
+    struct Shared {
+        bool verbose = false;
+        int count = 0;
+        std::string_view name;
+        slic::Collect<int, 2> levels;
+        std::string_view input;
+        std::optional<int> second;
+        slic::ArgSpan rest;
+
+        static constexpr auto Options = std::make_tuple(
+            slic::Option{"--verbose", "-v", &Shared::verbose},
+            slic::Option{"--count", "-c", &Shared::count}.range(-10, 10),
+            slic::Option{"--name", "-n", &Shared::name},
+            slic::Option{"--level", "-l", &Shared::levels},
+            slic::Arg{"input", &Shared::input},
+            slic::Arg{"second", &Shared::second},
+            slic::VarArgs{&Shared::rest}
+        );
+    };
+
+    /// @brief Common checks on the outcome of any parse of argc arguments.
+    void inspect(slic::ParseResult const& result, size_t argc) {
+        check(result.isOk() || result.argIndex == slic::ParseResult::NoArgIndex || result.argIndex < argc);
+        check(!result.errorMessage().empty());
+        if (!result.isOk()) {
+            for (std::string_view name : result.suggestions()) {
+                check(!name.empty());
+            }
+        }
+    }
+
+    template <class T>
+    void parse(std::vector<char const*>& argv) {
+        slic::ArgParser<T> parser(static_cast<int>(argv.size()), argv.data());
+        inspect(parser.parse(), argv.size());
+    }
+
+    void parseWithEnvironment(std::vector<char const*>& argv) {
+        char const* const envp[] = {"FUZZ_THREADS=300", "FUZZ_FORMAT=yaml", "FUZZ_DRY_RUN=maybe", "FUZZ_OTHER", nullptr};
+        slic::ArgParser<Checked> parser(static_cast<int>(argv.size()), argv.data());
+        inspect(parser.parseWithEnv(envp), argv.size());
+    }
+
+    void parseNumbers(std::vector<char const*>& argv) {
+        slic::ArgParser<Numbers> parser(static_cast<int>(argv.size()), argv.data());
+        auto result = parser.parse();
+        inspect(result, argv.size());
+        if (result.isOk()) {
+            long long sum = 0;
+            for (auto value : parser.result().values) {
+                sum += value.value_or(0);
+            }
+            std::vector<int> out(parser.result().values.size());
+            auto converted = parser.result().values.convertInto(out);
+            inspect(converted, argv.size());
+            if (converted.isOk()) {
+                long long again = 0;
+                for (int value : out) again += value;
+                check(again == sum);
+            }
+        }
+    }
+
+    /// @brief The permuted argv must hold the same tokens and parse the same way again.
+    void parsePermuted(std::vector<char const*>& argv) {
+        auto original = argv;
+        slic::ArgParser<Permuted> parser(static_cast<int>(argv.size()), argv.data());
+        auto result = parser.parse();
+        inspect(result, argv.size());
+        if (result.isOk()) {
+            auto sorted = [](std::vector<char const*> ptrs) {
+                std::sort(ptrs.begin(), ptrs.end());
+                return ptrs;
+            };
+            check(sorted(original) == sorted(argv));
+
+            // an already permuted argv stays as it is
+            Permuted first = parser.result();
+            auto permuted = argv;
+            check(parser.parse().isOk());
+            check(argv == permuted);
+            auto const& again = parser.result();
+            check(again.verbose == first.verbose && again.count == first.count && again.input == first.input);
+            check(again.rest.size() == first.rest.size());
+            for (size_t i = 0; i < first.rest.size() && i < again.rest.size(); ++i) {
+                check(again.rest[i].data() == first.rest[i].data());
+            }
+        }
+    }
+
+    void parseLazily(std::vector<char const*>& argv) {
+        slic::ArgParser<Scalars> parser(static_cast<int>(argv.size()), argv.data());
+        auto positionals = parser.positionals();
+        for (std::string_view value : positionals) {
+            check(positionals.index() < argv.size());
+            (void) value;
+        }
+        inspect(positionals.result(), argv.size());
+    }
+
+    void parseBoth(std::vector<char const*>& argv) {
+        slic::ArgParser<Shared> full(static_cast<int>(argv.size()), argv.data());
+        slic::CompactArgParser<Shared> compact(static_cast<int>(argv.size()), argv.data());
+        auto expected = full.parse();
+        auto result = compact.parse();
+        inspect(result, argv.size());
+        check(result.error == expected.error);
+        check(result.context == expected.context);
+        check(result.argIndex == expected.argIndex);
+        check(result.value == expected.value && (result.value.data() == nullptr) == (expected.value.data() == nullptr));
+    }
+
+    void parseLine(std::string_view line) {
+        std::string_view tokens[32];
+        char scratch[512];
+        slic::Tokenizer tokenizer(tokens, scratch);
+        slic::ArgParser<Scalars> parser;
+        auto result = parser.parseString(line, tokenizer);
+        inspect(result, tokenizer.tokens().size());
+    }
+} // namespace
+
+extern "C" int LLVMFuzzerTestOneInput(uint8_t const* data, size_t size) {
+    if (size == 0) {
+        return 0;
+    }
+    unsigned target = data[0] % 8;
+    std::string_view text(reinterpret_cast<char const*>(data + 1), size - 1);
+
+    if (target == 7) {
+        if (text.size() <= 512) parseLine(text);
+        return 0;
+    }
+
+    // owned copies, so every argument is NUL-terminated like real argv
+    std::vector<std::string> args{"fuzz"};
+    while (!text.empty()) {
+        auto end = text.find('\n');
+        args.emplace_back(text.substr(0, end));
+        text.remove_prefix(end == std::string_view::npos ? text.size() : end + 1);
+    }
+    std::vector<char const*> argv;
+    argv.reserve(args.size());
+    for (auto const& arg : args) argv.push_back(arg.c_str());
+
+    switch (target) {
+        case 0: parse<Scalars>(argv); parseLazily(argv); break;
+        case 1: parse<Repeated>(argv); break;
+        case 2: parse<Checked>(argv); parseWithEnvironment(argv); break;
+        case 3: parse<Git>(argv); break;
+        case 4: parsePermuted(argv); break;
+        case 5: parseNumbers(argv); break;
+        case 6: parseBoth(argv); break;
+    }
+    return 0;
+}
@@ -0,0 +1,38 @@
+// Runs LLVMFuzzerTestOneInput over files and directories of inputs, for compilers without
+// libFuzzer. Arguments starting with '-' are libFuzzer flags and ignored.
+
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+extern "C" int LLVMFuzzerTestOneInput(uint8_t const* data, size_t size);
+
+static size_t replay(std::filesystem::path const& path) {
+    std::ifstream file(path, std::ios::binary);
+    std::vector<char> bytes{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+    LLVMFuzzerTestOneInput(reinterpret_cast<uint8_t const*>(bytes.data()), bytes.size());
+    return 1;
+}
+
+int main(int argc, char** argv) {
+    size_t count = 0;
+    for (int i = 1; i < argc; ++i) {
+        if (argv[i][0] == '-') {
+            continue;
+        }
+        std::filesystem::path path = argv[i];
+        if (std::filesystem::is_directory(path)) {
+            for (auto const& entry : std::filesystem::recursive_directory_iterator(path)) {
+                if (entry.is_regular_file()) count += replay(entry.path());
+            }
+        } else {
+            count += replay(path);
+        }
+    }
+    std::printf("replayed %zu inputs\n", count);
+    return 0;
+}
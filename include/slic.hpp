@@ -3,15 +3,59 @@
 #define SLIC_ARG_PARSER_HPP
 
 #include <array>
+#include <atomic>
+#include <bit>
+#include <cerrno>
 #include <charconv>
 #include <cstdint>
+#include <cstdio>
 #include <cstdlib>
-#include <iostream>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
 #include <optional>
 #include <span>
+#include <string>
 #include <string_view>
 #include <tuple>
 #include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#elif !defined(__x86_64__) && !defined(__i386__)
+#include <chrono>
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#include <emmintrin.h>
+#define SLIC_HAS_SSE2 1
+#else
+#define SLIC_HAS_SSE2 0
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define SLIC_COLD [[gnu::cold, gnu::noinline]]
+#elif defined(_MSC_VER)
+#define SLIC_COLD __declspec(noinline)
+#else
+#define SLIC_COLD
+#endif
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#if defined(__GLIBC__)
+#include <stdio_ext.h>
+#endif
+
+extern "C" char** environ;
+#endif
 
 namespace slic {
     namespace detail {
@@ -31,28 +75,213 @@ namespace slic {
         constexpr bool is_optional_v<std::optional<T>> = true;
     } // namespace detail
 
+    /// @brief Destination for text output (help, errors), e.g. a file or a string buffer.
+    template <typename S>
+    concept OutputSink = requires(S& sink, std::string_view text) {
+        sink.write(text);
+    };
+
+    /// @brief Output sink writing to a C stream, without going through iostreams.
+    struct FileSink {
+        std::FILE* file = stdout;
+
+        void write(std::string_view text) const noexcept {
+            write({text});
+        }
+
+        void write(std::initializer_list<std::string_view> parts) const noexcept {
+            write(std::span<std::string_view const>(parts.begin(), parts.size()));
+        }
+
+        /// @brief Writes all parts, with one system call per 8 of them. Buffered text in the stream
+        /// is flushed first so that it stays in front, which glibc lets us skip when there is none.
+        void write(std::span<std::string_view const> parts) const noexcept {
+        #if defined(_WIN32)
+            for (auto part : parts) {
+                std::fwrite(part.data(), 1, part.size(), file);
+            }
+        #else
+        #if defined(__GLIBC__)
+            if (::__fpending(file) > 0) {
+                std::fflush(file);
+            }
+        #else
+            std::fflush(file);
+        #endif
+            int fd = ::fileno(file);
+
+            // batches of up to 8 parts, one writev each; a part never gets dropped
+            iovec vecs[8];
+            size_t count = 0;
+            for (auto part : parts) {
+                if (part.empty()) continue;
+                vecs[count++] = {const_cast<char*>(part.data()), part.size()};
+                if (count == std::size(vecs)) {
+                    if (!writeAll(fd, vecs, count)) return;
+                    count = 0;
+                }
+            }
+            if (count > 0) {
+                writeAll(fd, vecs, count);
+            }
+        #endif
+        }
+
+    private:
+    #if !defined(_WIN32)
+        /// @brief writev until every byte of vecs is out, resuming after short writes.
+        /// @return false if the descriptor failed.
+        static bool writeAll(int fd, iovec* vecs, size_t count) noexcept {
+            while (count > 0) {
+                ssize_t written = ::writev(fd, vecs, static_cast<int>(count));
+                if (written < 0 && errno == EINTR) {
+                    continue;
+                }
+                if (written <= 0) {
+                    return false;
+                }
+                auto done = static_cast<size_t>(written);
+                while (count > 0 && done >= vecs->iov_len) {
+                    done -= vecs->iov_len;
+                    ++vecs;
+                    --count;
+                }
+                if (count > 0) {
+                    vecs->iov_base = static_cast<char*>(vecs->iov_base) + done;
+                    vecs->iov_len -= done;
+                }
+            }
+            return true;
+        }
+    #endif
+    };
+
+    namespace detail {
+        /// @brief Writes all parts to the sink, in one call if the sink supports batches.
+        template <OutputSink S>
+        constexpr void writeParts(S& sink, std::initializer_list<std::string_view> parts) {
+            if constexpr (requires { sink.write(parts); }) {
+                sink.write(parts);
+            } else {
+                for (auto part : parts) {
+                    sink.write(part);
+                }
+            }
+        }
+
+        /// @copydoc writeParts
+        template <OutputSink S>
+        constexpr void writeParts(S& sink, std::span<std::string_view const> parts) {
+            if constexpr (requires { sink.write(parts); }) {
+                sink.write(parts);
+            } else {
+                for (auto part : parts) {
+                    sink.write(part);
+                }
+            }
+        }
+
+        /// @brief Optimal string alignment distance (adjacent swaps count as one edit), capped at limit + 1.
+        constexpr size_t editDistance(std::string_view a, std::string_view b, size_t limit) noexcept {
+            constexpr size_t MaxLength = 63;
+            size_t diff = a.size() > b.size() ? a.size() - b.size() : b.size() - a.size();
+            if (diff > limit || a.size() > MaxLength || b.size() > MaxLength) {
+                return limit + 1;
+            }
+
+            std::array<size_t, MaxLength + 1> prevPrev{}, prev{}, row{};
+            for (size_t j = 0; j <= b.size(); ++j) {
+                prev[j] = j;
+            }
+            for (size_t i = 1; i <= a.size(); ++i) {
+                row[0] = i;
+                size_t best = row[0];
+                for (size_t j = 1; j <= b.size(); ++j) {
+                    size_t cost = a[i - 1] == b[j - 1] ? 0 : 1;
+                    size_t value = prev[j - 1] + cost;
+                    if (prev[j] + 1 < value) value = prev[j] + 1;
+                    if (row[j - 1] + 1 < value) value = row[j - 1] + 1;
+                    if (i > 1 && j > 1 && a[i - 1] == b[j - 2] && a[i - 2] == b[j - 1] && prevPrev[j - 2] + 1 < value) {
+                        value = prevPrev[j - 2] + 1;
+                    }
+                    row[j] = value;
+                    if (value < best) best = value;
+                }
+                if (best > limit) {
+                    return limit + 1;
+                }
+                prevPrev = prev;
+                prev = row;
+            }
+            return prev[b.size()] > limit ? limit + 1 : prev[b.size()];
+        }
+
+        constexpr std::string_view stripDashes(std::string_view name) noexcept {
+            while (name.starts_with('-')) {
+                name.remove_prefix(1);
+            }
+            return name;
+        }
+    } // namespace detail
+
     enum class ParseError : uint8_t {
         None = 0,
         MissingValue,
         InvalidValue,
         UnknownOption,
         MissingRequiredArg,
-        TooManyArgs
+        TooManyArgs,
+        InvalidResponseFile,
+        TooManyValues,
+        UnknownCommand,
+        TooManyTokens,
+        MissingRequiredOption,
+        AmbiguousOption,
+        InvalidConfigFile,
+        CompletionWritten   ///< not a failure: shell completions were printed, exit successfully
+    };
+
+    /// @brief Up to three names close to an unknown option or command, closest first.
+    struct Suggestions {
+        std::array<std::string_view, 3> names{};
+        size_t count = 0;
+
+        [[nodiscard]] constexpr bool empty() const noexcept { return count == 0; }
+        [[nodiscard]] constexpr size_t size() const noexcept { return count; }
+        [[nodiscard]] constexpr std::string_view operator[](size_t i) const noexcept { return names[i]; }
+        [[nodiscard]] constexpr auto begin() const noexcept { return names.begin(); }
+        [[nodiscard]] constexpr auto end() const noexcept { return names.begin() + count; }
     };
 
     /// @brief Result of a parsing operation with error information.
     struct ParseResult {
+        static constexpr size_t NoArgIndex = SIZE_MAX;
+
         ParseError error = ParseError::None;
         std::string_view context{};
+        /// @brief Index into argv of the argument that failed, NoArgIndex if it didn't come from argv.
+        size_t argIndex = NoArgIndex;
+        /// @brief Names known where the error happened, used for suggestions().
+        std::span<std::string_view const> const* candidates = nullptr;
+        /// @brief The value that broke the constraints described by context, no data otherwise.
+        std::string_view value{};
 
         [[nodiscard]] constexpr bool isOk() const noexcept { return error == ParseError::None; }
         [[nodiscard]] constexpr explicit operator bool() const noexcept { return isOk(); }
+        /// @brief Not a failure: parse() already did the job (printed shell completions) and the
+        /// program should exit with 0. print() writes nothing for it.
+        [[nodiscard]] constexpr bool handled() const noexcept { return error == ParseError::CompletionWritten; }
 
         static constexpr ParseResult success() noexcept { return {}; }
         static constexpr ParseResult failure(ParseError err, std::string_view ctx = {}) noexcept {
             return {err, ctx};
         }
 
+        /// @brief InvalidValue for a value that converted but broke the constraints described by ctx.
+        static constexpr ParseResult violation(std::string_view ctx, std::string_view value) noexcept {
+            return {ParseError::InvalidValue, ctx, NoArgIndex, nullptr, value};
+        }
+
         [[nodiscard]] constexpr std::string_view errorMessage() const noexcept {
             switch (error) {
                 case ParseError::None: return "Success";
@@ -61,21 +290,262 @@ namespace slic {
                 case ParseError::UnknownOption: return "Unknown option";
                 case ParseError::MissingRequiredArg: return "Missing required argument";
                 case ParseError::TooManyArgs: return "Too many arguments";
+                case ParseError::InvalidResponseFile: return "Cannot read response file";
+                case ParseError::TooManyValues: return "Too many values for option";
+                case ParseError::UnknownCommand: return "Unknown command";
+                case ParseError::TooManyTokens: return "Command line doesn't fit the tokenizer buffers";
+                case ParseError::MissingRequiredOption: return "Missing required option";
+                case ParseError::AmbiguousOption: return "Ambiguous option";
+                case ParseError::InvalidConfigFile: return "Cannot read config file";
+                case ParseError::CompletionWritten: return "Shell completions were written";
             }
             return "Unknown error";
         }
 
+        /// @brief Names similar to an unknown option or command, or the first names an ambiguous
+        /// abbreviation matches. Only computed when called.
+        SLIC_COLD constexpr Suggestions suggestions() const noexcept {
+            Suggestions result;
+            if (candidates && error == ParseError::AmbiguousOption) {
+                for (std::string_view name : *candidates) {
+                    if (name.starts_with(context) && result.count < result.names.size()) {
+                        result.names[result.count++] = name;
+                    }
+                }
+                return result;
+            }
+            if (!candidates || (error != ParseError::UnknownOption && error != ParseError::UnknownCommand)) {
+                return result;
+            }
+
+            // one-letter names only match when just the dashes are off, e.g. --v for -v
+            auto input = detail::stripDashes(context);
+            size_t limit = input.size() < 6 ? 1 : input.size() / 3;
+            std::array<size_t, 3> distances{};
+            for (std::string_view name : *candidates) {
+                if (name == context) continue;
+                if (input.size() == 1 && detail::stripDashes(name) != input) continue;
+                // config file keys come without dashes
+                auto target = context.starts_with('-') ? name : detail::stripDashes(name);
+                size_t distance = detail::editDistance(context, target, limit);
+                if (distance > limit) continue;
+
+                // insert sorted by distance, keeping the first match of equal ones in front
+                size_t pos = result.count;
+                while (pos > 0 && distances[pos - 1] > distance) {
+                    --pos;
+                }
+                if (pos >= result.names.size()) continue;
+                size_t last = result.count < result.names.size() ? result.count : result.names.size() - 1;
+                for (size_t i = last; i > pos; --i) {
+                    result.names[i] = result.names[i - 1];
+                    distances[i] = distances[i - 1];
+                }
+                result.names[pos] = name;
+                distances[pos] = distance;
+                if (result.count < result.names.size()) ++result.count;
+            }
+            return result;
+        }
+
         /// @brief Prints the error message to stderr.
         void print() const noexcept {
-            if (isOk()) return;
+            print(FileSink{stderr});
+        }
+
+        /// @brief Writes the error message and any suggestions to the given sink, in one batch.
+        template <OutputSink S>
+        constexpr void print(S&& sink) const {
+            if (isOk() || handled()) return;
+            std::array<std::string_view, 20> parts{};
+            size_t count = 0;
+            auto add = [&](std::initializer_list<std::string_view> more) {
+                for (auto part : more) parts[count++] = part;
+            };
             if (context.empty()) {
-                std::cerr << "Error: " << errorMessage() << std::endl;
+                add({"Error: ", errorMessage(), "\n"});
+            } else if (value.data() != nullptr) {
+                add({"Error: ", errorMessage(), " '", value, "' for '", context, "'\n"});
             } else {
-                std::cerr << "Error: " << errorMessage() << " '" << context << '\'' << std::endl;
+                add({"Error: ", errorMessage(), " '", context, "'\n"});
+            }
+            if (candidates) {
+                count = addSuggestions(parts, count);
+            }
+            detail::writeParts(sink, std::span<std::string_view const>(parts.data(), count));
+        }
+
+    private:
+        /// @brief Appends "Did you mean ...?" to parts[count, count + 10) and returns the new count.
+        SLIC_COLD constexpr size_t addSuggestions(std::array<std::string_view, 20>& parts, size_t count) const {
+            auto similar = suggestions();
+            if (similar.empty()) return count;
+            for (size_t i = 0; i < similar.size(); ++i) {
+                parts[count++] = i == 0 ? "Did you mean '" : i + 1 == similar.size() ? " or '" : ", '";
+                parts[count++] = similar[i];
+                parts[count++] = "'";
             }
+            parts[count++] = "?\n";
+            return count;
         }
     };
 
+    /// @brief Kind of a command line token, decided by its first characters.
+    enum class TokenKind : uint8_t {
+        Positional,
+        Short,      ///< "-" followed by anything but '-'
+        Long,       ///< "--name"
+        Separator   ///< "--"
+    };
+
+    namespace detail {
+        class TokenCursor;
+        class ArgPermuter;
+    }
+
+    /// @brief Specialize with a `static constexpr std::array Names` of {name, value} pairs,
+    /// e.g. `std::pair{"fast", Mode::Fast}`, to parse the enum E by name.
+    template <typename E>
+    struct EnumTraits {};
+
+    namespace detail {
+        template <typename E>
+        concept named_enum = std::is_enum_v<E> && requires { EnumTraits<E>::Names; };
+
+        template <typename E>
+        constexpr std::optional<E> parseEnum(std::string_view input) noexcept;
+
+        /// @brief Decimal digits like std::from_chars reads them: an optional '-' for signed types
+        /// only, no '+', and no values out of range.
+        template <typename T>
+        constexpr std::optional<T> parseInteger(std::string_view input) noexcept {
+            using U = std::make_unsigned_t<T>;
+            bool negative = std::is_signed_v<T> && !input.empty() && input.front() == '-';
+            size_t i = negative ? 1 : 0;
+            if (i == input.size()) {
+                return std::nullopt;
+            }
+
+            U limit = static_cast<U>(std::numeric_limits<T>::max()) + (negative ? 1 : 0);
+            U value = 0;
+            for (; i < input.size(); ++i) {
+                if (input[i] < '0' || input[i] > '9') {
+                    return std::nullopt;
+                }
+                auto digit = static_cast<U>(input[i] - '0');
+                if (value > (limit - digit) / 10) {
+                    return std::nullopt;
+                }
+                value = static_cast<U>(value * 10 + digit);
+            }
+            return static_cast<T>(negative ? static_cast<U>(0 - value) : value);
+        }
+
+        [[nodiscard]] constexpr bool equalsIgnoreCase(std::string_view text, std::string_view lower) noexcept {
+            if (text.size() != lower.size()) return false;
+            for (size_t i = 0; i < text.size(); ++i) {
+                char c = text[i] >= 'A' && text[i] <= 'Z' ? static_cast<char>(text[i] - 'A' + 'a') : text[i];
+                if (c != lower[i]) return false;
+            }
+            return true;
+        }
+
+        /// @brief The syntax std::from_chars accepts for floating point, for constant evaluation where it
+        /// isn't constexpr. Exact up to 15 significant digits and powers of ten within 1e±22, the range
+        /// of default values; beyond that the last bit may differ from std::from_chars.
+        template <typename T>
+        constexpr std::optional<T> parseFloat(std::string_view input) noexcept {
+            bool negative = !input.empty() && input.front() == '-';
+            if (negative) {
+                input.remove_prefix(1);
+            }
+            if (equalsIgnoreCase(input, "inf") || equalsIgnoreCase(input, "infinity")) {
+                return negative ? -std::numeric_limits<T>::infinity() : std::numeric_limits<T>::infinity();
+            }
+            if (equalsIgnoreCase(input, "nan")) {
+                return std::numeric_limits<T>::quiet_NaN();
+            }
+
+            // up to 19 significant digits, the rest only moves the exponent
+            uint64_t mantissa = 0;
+            int digits = 0;
+            int exponent = 0;
+            bool any = false;
+            size_t i = 0;
+            for (bool fraction = false; i < input.size(); ++i) {
+                char c = input[i];
+                if (c == '.' && !fraction) {
+                    fraction = true;
+                    continue;
+                }
+                if (c < '0' || c > '9') {
+                    break;
+                }
+                any = true;
+                if (digits < 19) {
+                    mantissa = mantissa * 10 + static_cast<uint64_t>(c - '0');
+                    digits += mantissa != 0;
+                    exponent -= fraction;
+                } else {
+                    exponent += !fraction;
+                }
+            }
+            if (!any) {
+                return std::nullopt;
+            }
+            if (i < input.size()) {
+                if (input[i] != 'e' && input[i] != 'E') {
+                    return std::nullopt;
+                }
+                bool negativeExponent = false;
+                if (++i < input.size() && (input[i] == '-' || input[i] == '+')) {
+                    negativeExponent = input[i++] == '-';
+                }
+                if (i == input.size()) {
+                    return std::nullopt;
+                }
+                int written = 0;
+                for (; i < input.size(); ++i) {
+                    if (input[i] < '0' || input[i] > '9') {
+                        return std::nullopt;
+                    }
+                    if (written < 100'000) written = written * 10 + (input[i] - '0');
+                }
+                exponent += negativeExponent ? -written : written;
+            }
+
+            long double result = static_cast<long double>(mantissa);
+            if (mantissa != 0) {
+                if (mantissa < (uint64_t{1} << 53) && exponent >= -22 && exponent <= 22) {
+                    // both operands are exact doubles, so the one rounding is the correct one
+                    double scale = 1;
+                    for (int e = exponent < 0 ? -exponent : exponent; e > 0; --e) scale *= 10;
+                    double exact = static_cast<double>(mantissa);
+                    result = exponent < 0 ? exact / scale : exact * scale;
+                } else {
+                    // 10^e as the exact 5^e times 2^e, in steps whose 5^e fits 64 bits
+                    while (exponent != 0 && result > 0 && result <= std::numeric_limits<long double>::max()) {
+                        int step = exponent < 0 ? (exponent < -27 ? 27 : -exponent) : (exponent > 27 ? 27 : exponent);
+                        uint64_t five = 1;
+                        long double two = 1;
+                        for (int e = 0; e < step; ++e) {
+                            five *= 5;
+                            two *= 2;
+                        }
+                        result = exponent < 0 ? result / static_cast<long double>(five) / two
+                                              : result * static_cast<long double>(five) * two;
+                        exponent += exponent < 0 ? step : -step;
+                    }
+                }
+                if (result > std::numeric_limits<T>::max() || static_cast<T>(result) == 0) {
+                    return std::nullopt; // out of range, as std::from_chars reports it
+                }
+            }
+            auto value = static_cast<T>(result);
+            return negative ? -value : value;
+        }
+    }
+
     template <typename T>
     struct ValueParser {
         static constexpr std::optional<T> parse(std::string_view input) noexcept {
@@ -90,12 +560,21 @@ namespace slic {
             } else if constexpr (std::is_same_v<T, std::string_view>) {
                 return input;
             } else if constexpr (std::is_arithmetic_v<T>) {
+                if (std::is_constant_evaluated()) {
+                    if constexpr (std::is_integral_v<T>) {
+                        return detail::parseInteger<T>(input);
+                    } else {
+                        return detail::parseFloat<T>(input);
+                    }
+                }
                 T value{};
                 auto [ptr, ec] = std::from_chars(input.data(), input.data() + input.size(), value);
                 if (ec == std::errc{} && ptr == input.data() + input.size()) {
                     return value;
                 }
                 return std::nullopt;
+            } else if constexpr (detail::named_enum<T>) {
+                return detail::parseEnum<T>(input);
             } else {
                 return std::nullopt;
             }
@@ -107,485 +586,3765 @@ namespace slic {
         using value_type = std::string_view;
 
         struct iterator {
-            char const* const* ptr;
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = std::string_view;
+            using difference_type = std::ptrdiff_t;
+            using pointer = void;
+            using reference = std::string_view;
 
-            constexpr std::string_view operator*() const noexcept { return *ptr; }
-            constexpr iterator& operator++() noexcept { ++ptr; return *this; }
-            constexpr iterator operator++(int) noexcept { auto tmp = *this; ++ptr; return tmp; }
+            char const* const* ptrs = nullptr;
+            std::string_view const* views = nullptr;
+            size_t idx = 0;
+
+            constexpr std::string_view operator*() const noexcept { return views ? views[idx] : ptrs[idx]; }
+            constexpr iterator& operator++() noexcept { ++idx; return *this; }
+            constexpr iterator operator++(int) noexcept { auto tmp = *this; ++idx; return tmp; }
             constexpr bool operator==(iterator const&) const noexcept = default;
         };
 
         constexpr ArgSpan() noexcept = default;
-        constexpr ArgSpan(std::span<char const* const> args) noexcept : m_args(args) {}
+        constexpr ArgSpan(std::span<char const* const> args) noexcept
+            : m_ptrs(args.data()), m_size(args.size()) {}
+        constexpr ArgSpan(std::span<std::string_view const> args) noexcept
+            : m_views(args.data()), m_size(args.size()) {}
 
-        [[nodiscard]] constexpr iterator begin() const noexcept { return {m_args.data()}; }
-        [[nodiscard]] constexpr iterator end() const noexcept { return {m_args.data() + m_args.size()}; }
-        [[nodiscard]] constexpr size_t size() const noexcept { return m_args.size(); }
-        [[nodiscard]] constexpr bool empty() const noexcept { return m_args.empty(); }
-        [[nodiscard]] constexpr std::string_view operator[](size_t idx) const noexcept { return m_args[idx]; }
-        [[nodiscard]] constexpr std::string_view front() const noexcept { return m_args.front(); }
-        [[nodiscard]] constexpr std::string_view back() const noexcept { return m_args.back(); }
+        [[nodiscard]] constexpr iterator begin() const noexcept { return {m_ptrs, m_views, 0}; }
+        [[nodiscard]] constexpr iterator end() const noexcept { return {m_ptrs, m_views, m_size}; }
+        [[nodiscard]] constexpr size_t size() const noexcept { return m_size; }
+        [[nodiscard]] constexpr bool empty() const noexcept { return m_size == 0; }
+        [[nodiscard]] constexpr std::string_view operator[](size_t idx) const noexcept {
+            return m_views ? m_views[idx] : m_ptrs[idx];
+        }
+        [[nodiscard]] constexpr std::string_view front() const noexcept { return (*this)[0]; }
+        [[nodiscard]] constexpr std::string_view back() const noexcept { return (*this)[m_size - 1]; }
+
+        /// @brief Returns the arguments starting at offset.
+        [[nodiscard]] constexpr ArgSpan subspan(size_t offset) const noexcept {
+            if (m_views) {
+                return std::span<std::string_view const>{m_views + offset, m_size - offset};
+            }
+            return std::span<char const* const>{m_ptrs + offset, m_size - offset};
+        }
 
     private:
-        std::span<char const* const> m_args{};
+        friend class detail::TokenCursor;
+        friend class detail::ArgPermuter;
+
+        char const* const* m_ptrs = nullptr;
+        std::string_view const* m_views = nullptr;
+        size_t m_size = 0;
     };
 
-    /// @brief Represents a command-line option. (e.g., --option or -o)
-    template <typename T, typename S>
-    struct Option {
-        using Type = T;
-        using Parent = S;
+    namespace detail {
+        /// @brief Reorders arguments in place for permute mode, like getopt does with argv.
+        /// The storage behind the span must be writable, as main's argv is.
+        ///
+        /// Tokens are added left to right, and the options go in front of the non-options with both
+        /// kept in their order. Pending runs are merged by rotation once the newer one is at least half
+        /// as long as the older one, so there are at most log2(n) of them, every token is moved at most
+        /// once per level (O(n log n) for fully interleaved argv), and a single run of non-options followed
+        /// by options costs one rotation.
+        class ArgPermuter {
+        public:
+            constexpr explicit ArgPermuter(ArgSpan args) noexcept : m_args(args) {}
 
-        constexpr Option(std::string_view name, T S::* field) noexcept
-            : m_name(name), m_field(field) {}
+            /// @brief Adds args[first, last), either options with their values or non-options, behind the
+            /// tokens added before.
+            constexpr void add(size_t first, size_t last, bool options) noexcept {
+                if (m_depth > 0 && (!options || m_runs[m_depth - 1].middle == m_runs[m_depth - 1].last)) {
+                    Run& top = m_runs[m_depth - 1];
+                    top.last = last;
+                    if (options) {
+                        top.middle = last;
+                    }
+                } else {
+                    m_runs[m_depth++] = {first, options ? last : first, last};
+                }
+                while (m_depth > 1 && m_runs[m_depth - 2].size() <= 2 * m_runs[m_depth - 1].size()) {
+                    merge();
+                }
+            }
 
-        constexpr Option(std::string_view name, std::string_view altName, T S::* field) noexcept
-            : m_name(name), m_altName(altName), m_field(field) {}
+            /// @brief Moves the non-options behind all options and returns the index of the first one.
+            constexpr size_t finish() noexcept {
+                while (m_depth > 1) {
+                    merge();
+                }
+                return m_depth > 0 ? m_runs[0].middle : m_args.size();
+            }
 
-        constexpr Option(std::string_view name, T S::* field, std::string_view description) noexcept
-            : m_name(name), m_description(description), m_field(field) {}
+        private:
+            static constexpr void swap(ArgSpan args, size_t a, size_t b) noexcept {
+                if (args.m_views) {
+                    auto* views = const_cast<std::string_view*>(args.m_views);
+                    std::swap(views[a], views[b]);
+                } else {
+                    auto* ptrs = const_cast<char const**>(args.m_ptrs);
+                    std::swap(ptrs[a], ptrs[b]);
+                }
+            }
 
-        constexpr Option(std::string_view name, std::string_view altName, T S::* field, std::string_view description) noexcept
-            : m_name(name), m_altName(altName), m_description(description), m_field(field) {}
+            /// @brief Moves args[middle, last) in front of args[first, middle).
+            static constexpr void rotate(ArgSpan args, size_t first, size_t middle, size_t last) noexcept {
+                reverse(args, first, middle);
+                reverse(args, middle, last);
+                reverse(args, first, last);
+            }
 
-        [[nodiscard]] constexpr std::string_view name() const noexcept { return m_name; }
-        [[nodiscard]] constexpr std::string_view altName() const noexcept { return m_altName; }
-        [[nodiscard]] constexpr std::string_view description() const noexcept { return m_description; }
-        [[nodiscard]] constexpr Type Parent::* field() const noexcept { return m_field; }
+            static constexpr void reverse(ArgSpan args, size_t first, size_t last) noexcept {
+                while (first + 1 < last) {
+                    swap(args, first++, --last);
+                }
+            }
 
-        [[nodiscard]] constexpr bool matches(std::string_view arg) const noexcept {
-            return arg == m_name || arg == m_altName;
-        }
+            /// @brief Options in args[first, middle), then non-options in args[middle, last).
+            struct Run {
+                size_t first = 0;
+                size_t middle = 0;
+                size_t last = 0;
 
-        [[nodiscard]] static constexpr bool needsValue() noexcept {
-            using Inner = detail::unwrap_optional_t<T>;
-            return !std::is_same_v<Inner, bool>;
-        }
+                [[nodiscard]] constexpr size_t size() const noexcept { return last - first; }
+            };
 
-    private:
-        std::string_view m_name{};
-        std::string_view m_altName{};
-        std::string_view m_description{};
-        T S::* m_field{};
-    };
+            /// @brief Merges the top two runs by moving the options of the newer one in front of the
+            /// non-options of the older one.
+            constexpr void merge() noexcept {
+                Run& older = m_runs[m_depth - 2];
+                Run const& newer = m_runs[m_depth - 1];
+                if (older.middle != older.last && newer.first != newer.middle) {
+                    rotate(m_args, older.middle, older.last, newer.middle);
+                }
+                older.middle += newer.middle - newer.first;
+                older.last = newer.last;
+                --m_depth;
+            }
 
-    /// @brief Represents a positional argument (e.g., filename).
-    template <typename T, typename S>
-    struct Arg {
-        using Type = T;
-        using Parent = S;
+            ArgSpan m_args;
+            std::array<Run, 64> m_runs{};
+            size_t m_depth = 0;
+        };
+    }
 
-        constexpr Arg(std::string_view name, T S::* field) noexcept
-            : m_name(name), m_field(field) {}
+    /// @brief VarArgs tail whose values are converted to T with ValueParser<T> as they are read.
+    /// Reading yields std::optional<T>, empty for a value that doesn't convert; convertInto()
+    /// converts and validates all of them at once.
+    template <typename T>
+    class TypedArgSpan {
+    public:
+        using value_type = std::optional<T>;
 
-        constexpr Arg(std::string_view name, T S::* field, std::string_view description) noexcept
-            : m_name(name), m_description(description), m_field(field) {}
+        struct iterator {
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = std::optional<T>;
+            using difference_type = std::ptrdiff_t;
+            using pointer = void;
+            using reference = std::optional<T>;
 
-        [[nodiscard]] constexpr std::string_view name() const noexcept { return m_name; }
-        [[nodiscard]] constexpr std::string_view description() const noexcept { return m_description; }
-        [[nodiscard]] constexpr Type Parent::* field() const noexcept { return m_field; }
+            ArgSpan::iterator it;
 
-        [[nodiscard]] static consteval bool isOptional() noexcept {
-            return detail::is_optional_v<T>;
-        }
+            constexpr std::optional<T> operator*() const noexcept { return ValueParser<T>::parse(*it); }
+            constexpr iterator& operator++() noexcept { ++it; return *this; }
+            constexpr iterator operator++(int) noexcept { auto tmp = *this; ++it; return tmp; }
+            constexpr bool operator==(iterator const&) const noexcept = default;
+        };
 
-    private:
-        std::string_view m_name{};
-        std::string_view m_description{};
-        T S::* m_field{};
-    };
+        constexpr TypedArgSpan() noexcept = default;
+        /// @param argIndex Argument index of args[0], used in conversion errors.
+        constexpr explicit TypedArgSpan(ArgSpan args, size_t argIndex = ParseResult::NoArgIndex) noexcept
+            : m_args(args), m_argIndex(argIndex) {}
 
-    /// @brief Represents variadic arguments, that attaches to ArgSpan.
-    template <typename S>
-    struct VarArgs {
-        using Type = ArgSpan;
-        using Parent = S;
+        [[nodiscard]] constexpr iterator begin() const noexcept { return {m_args.begin()}; }
+        [[nodiscard]] constexpr iterator end() const noexcept { return {m_args.end()}; }
+        [[nodiscard]] constexpr size_t size() const noexcept { return m_args.size(); }
+        [[nodiscard]] constexpr bool empty() const noexcept { return m_args.empty(); }
+        [[nodiscard]] constexpr std::optional<T> operator[](size_t idx) const noexcept {
+            return ValueParser<T>::parse(m_args[idx]);
+        }
+        /// @brief The unconverted values.
+        [[nodiscard]] constexpr ArgSpan raw() const noexcept { return m_args; }
 
-        constexpr VarArgs(ArgSpan S::* field) noexcept
-            : m_field(field) {}
+        /// @brief Converts the first out.size() values (normally all of them) into out.
+        /// @return InvalidValue for the first value that doesn't convert, with its argument index.
+        constexpr ParseResult convertInto(std::span<T> out) const noexcept {
+            size_t count = out.size() < size() ? out.size() : size();
+            return failureAt(convertRange(out, 0, count));
+        }
 
-        constexpr VarArgs(std::string_view description, ArgSpan S::* field) noexcept
-            : m_description(description), m_field(field) {}
+        /// @brief Like convertInto(out), split into chunks converted on `threads` threads, one of them the
+        /// caller. Thread is std::thread, std::jthread or any type constructed from a callable and joined;
+        /// slic doesn't include <thread> itself. The reported value is the first bad one in argument order.
+        template <class Thread>
+        ParseResult convertInto(std::span<T> out, size_t threads) const {
+            size_t count = out.size() < size() ? out.size() : size();
+            threads = threads < 1 ? 1 : threads;
+            threads = threads > count ? (count ? count : 1) : threads;
+            size_t chunk = (count + threads - 1) / threads;
 
-        [[nodiscard]] constexpr std::string_view description() const { return m_description; }
-        [[nodiscard]] constexpr Type Parent::* field() const noexcept { return m_field; }
+            std::vector<size_t> failed(threads, NoFailure);
+            std::vector<Thread> workers;
+            workers.reserve(threads - 1);
+            for (size_t t = 1; t < threads; ++t) {
+                size_t first = t * chunk < count ? t * chunk : count;
+                size_t last = first + chunk < count ? first + chunk : count;
+                workers.emplace_back([this, out, first, last, &failed, t] { failed[t] = convertRange(out, first, last); });
+            }
+            failed[0] = convertRange(out, 0, chunk < count ? chunk : count);
+            for (auto& worker : workers) {
+                worker.join();
+            }
+
+            for (size_t index : failed) {
+                if (index != NoFailure) {
+                    return failureAt(index);
+                }
+            }
+            return ParseResult::success();
+        }
 
     private:
-        std::string_view m_description{};
-        ArgSpan S::* m_field;
+        static constexpr size_t NoFailure = SIZE_MAX;
+
+        /// @return Index of the first value in [first, last) that doesn't convert, or NoFailure.
+        constexpr size_t convertRange(std::span<T> out, size_t first, size_t last) const noexcept {
+            for (size_t idx = first; idx < last; ++idx) {
+                auto parsed = ValueParser<T>::parse(m_args[idx]);
+                if (!parsed) {
+                    return idx;
+                }
+                out[idx] = *parsed;
+            }
+            return NoFailure;
+        }
+
+        constexpr ParseResult failureAt(size_t idx) const noexcept {
+            if (idx == NoFailure) {
+                return ParseResult::success();
+            }
+            auto result = ParseResult::failure(ParseError::InvalidValue, m_args[idx]);
+            result.argIndex = m_argIndex == ParseResult::NoArgIndex ? m_argIndex : m_argIndex + idx;
+            return result;
+        }
+
+        ArgSpan m_args;
+        size_t m_argIndex = ParseResult::NoArgIndex;
     };
 
     namespace detail {
         template <typename T>
-        struct is_option : std::false_type {};
-
-        template <typename T, typename S>
-        struct is_option<Option<T, S>> : std::true_type {};
+        struct is_typed_arg_span : std::false_type {};
 
         template <typename T>
-        constexpr bool is_option_v = is_option<std::remove_cvref_t<T>>::value;
+        struct is_typed_arg_span<TypedArgSpan<T>> : std::true_type {};
 
         template <typename T>
-        struct is_arg : std::false_type {};
+        constexpr bool is_typed_arg_span_v = is_typed_arg_span<T>::value;
 
-        template <typename T, typename S>
-        struct is_arg<Arg<T, S>> : std::true_type {};
-
-        template <typename T>
+        /// @brief Value of a VarArgs field of type F for args, which start at argument argIndex.
+        template <typename F>
+        constexpr F makeVarArgs(ArgSpan args, size_t argIndex) noexcept {
+            if constexpr (std::is_same_v<F, ArgSpan>) {
+                return args;
+            } else {
+                return F(args, argIndex);
+            }
+        }
+    }
+
+    /// @brief Fixed-capacity storage for every value of a repeatable option (e.g. -I dir -I dir2).
+    template <typename T, size_t N>
+    struct Collect {
+        using value_type = T;
+        using iterator = T const*;
+
+        static constexpr size_t Capacity = N;
+
+        /// @brief Appends a value, returns false if the container is full.
+        constexpr bool push(T value) noexcept {
+            if (m_size == N) return false;
+            m_values[m_size++] = value;
+            return true;
+        }
+
+        constexpr void clear() noexcept { m_size = 0; }
+
+        [[nodiscard]] constexpr iterator begin() const noexcept { return m_values.data(); }
+        [[nodiscard]] constexpr iterator end() const noexcept { return m_values.data() + m_size; }
+        [[nodiscard]] constexpr size_t size() const noexcept { return m_size; }
+        [[nodiscard]] constexpr bool empty() const noexcept { return m_size == 0; }
+        [[nodiscard]] constexpr T const& operator[](size_t idx) const noexcept { return m_values[idx]; }
+        [[nodiscard]] constexpr T const& front() const noexcept { return m_values[0]; }
+        [[nodiscard]] constexpr T const& back() const noexcept { return m_values[m_size - 1]; }
+
+    private:
+        std::array<T, N> m_values{};
+        size_t m_size = 0;
+    };
+
+    /// @brief Like Collect, but only keeps a view of each value in argv and converts it on access.
+    /// Values are still validated while parsing.
+    template <typename T, size_t N>
+    struct CollectViews {
+        using value_type = T;
+
+        struct iterator {
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = T;
+            using difference_type = std::ptrdiff_t;
+            using reference = T;
+            using pointer = void;
+
+            std::string_view const* ptr;
+
+            constexpr T operator*() const noexcept { return *ValueParser<T>::parse(*ptr); }
+            constexpr iterator& operator++() noexcept { ++ptr; return *this; }
+            constexpr iterator operator++(int) noexcept { auto tmp = *this; ++ptr; return tmp; }
+            constexpr bool operator==(iterator const&) const noexcept = default;
+        };
+
+        static constexpr size_t Capacity = N;
+
+        /// @brief Appends a view of a value, returns false if the container is full.
+        constexpr bool push(std::string_view value) noexcept {
+            if (m_size == N) return false;
+            m_views[m_size++] = value;
+            return true;
+        }
+
+        constexpr void clear() noexcept { m_size = 0; }
+
+        [[nodiscard]] constexpr iterator begin() const noexcept { return {m_views.data()}; }
+        [[nodiscard]] constexpr iterator end() const noexcept { return {m_views.data() + m_size}; }
+        [[nodiscard]] constexpr size_t size() const noexcept { return m_size; }
+        [[nodiscard]] constexpr bool empty() const noexcept { return m_size == 0; }
+        [[nodiscard]] constexpr T operator[](size_t idx) const noexcept { return *ValueParser<T>::parse(m_views[idx]); }
+        [[nodiscard]] constexpr std::string_view view(size_t idx) const noexcept { return m_views[idx]; }
+
+    private:
+        std::array<std::string_view, N> m_views{};
+        size_t m_size = 0;
+    };
+
+    namespace detail {
+        template <typename T>
+        constexpr bool is_collect_v = false;
+
+        template <typename T, size_t N>
+        constexpr bool is_collect_v<Collect<T, N>> = true;
+
+        template <typename T>
+        constexpr bool is_collect_views_v = false;
+
+        template <typename T, size_t N>
+        constexpr bool is_collect_views_v<CollectViews<T, N>> = true;
+
+        /// @brief Type a value of the field is parsed as.
+        template <typename T>
+        struct field_value { using type = unwrap_optional_t<T>; };
+
+        template <typename T, size_t N>
+        struct field_value<Collect<T, N>> { using type = T; };
+
+        template <typename T, size_t N>
+        struct field_value<CollectViews<T, N>> { using type = T; };
+
+        template <typename T>
+        using field_value_t = field_value<T>::type;
+
+        /// @brief Checks on the values of an Option or Arg, applied right after conversion. All off by default.
+        template <typename V>
+        struct Constraints {
+            static constexpr size_t MaxChoices = 8;
+
+            V minimum{};
+            V maximum{};
+            std::array<V, MaxChoices> choices{};
+            size_t choiceCount = 0;
+            bool hasMinimum = false;
+            bool hasMaximum = false;
+            bool nonEmpty = false;
+
+            [[nodiscard]] constexpr bool any() const noexcept {
+                return hasMinimum || hasMaximum || nonEmpty || choiceCount > 0;
+            }
+
+            [[nodiscard]] constexpr bool accepts(V const& value) const noexcept {
+                if constexpr (std::is_arithmetic_v<V>) {
+                    if ((hasMinimum && value < minimum) || (hasMaximum && value > maximum)) {
+                        return false;
+                    }
+                } else {
+                    if (nonEmpty && value.empty()) {
+                        return false;
+                    }
+                }
+                if (choiceCount == 0) {
+                    return true;
+                }
+                for (size_t i = 0; i < choiceCount; ++i) {
+                    if (choices[i] == value) return true;
+                }
+                return false;
+            }
+
+            /// @brief More than MaxChoices values don't compile in constant evaluation; at run time the
+            /// extra ones are ignored rather than written past choices.
+            constexpr void setChoices(std::initializer_list<V> values) noexcept {
+                if (values.size() > MaxChoices) {
+                    too_many_choices();
+                }
+                choiceCount = 0;
+                for (auto const& value : values) {
+                    if (choiceCount == MaxChoices) break;
+                    choices[choiceCount++] = value;
+                }
+            }
+
+            static void too_many_choices() noexcept {}
+        };
+
+        /// @brief Stands in for Constraints on value types that can't be constrained.
+        struct NoConstraints {
+            [[nodiscard]] static constexpr bool any() noexcept { return false; }
+        };
+
+        template <typename V>
+        using constraints_t = std::conditional_t<
+            (std::is_arithmetic_v<V> && !std::is_same_v<V, bool>) || std::is_same_v<V, std::string_view>,
+            Constraints<V>, NoConstraints>;
+
+        template <typename V>
+        concept ordered_value = std::is_arithmetic_v<V> && !std::is_same_v<V, bool>;
+
+        template <typename V>
+        concept constrainable_value = !std::is_same_v<constraints_t<V>, NoConstraints>;
+    } // namespace detail
+
+    /// @brief Represents a command-line option. (e.g., --option or -o)
+    template <typename T, typename S>
+    struct Option {
+        using Type = T;
+        using Parent = S;
+
+        constexpr Option(std::string_view name, T S::* field) noexcept
+            : m_name(name), m_field(field) {}
+
+        constexpr Option(std::string_view name, std::string_view altName, T S::* field) noexcept
+            : m_name(name), m_altName(altName), m_field(field) {}
+
+        constexpr Option(std::string_view name, T S::* field, std::string_view description) noexcept
+            : m_name(name), m_description(description), m_field(field) {}
+
+        constexpr Option(std::string_view name, std::string_view altName, T S::* field, std::string_view description) noexcept
+            : m_name(name), m_altName(altName), m_description(description), m_field(field) {}
+
+        [[nodiscard]] constexpr std::string_view name() const noexcept { return m_name; }
+        [[nodiscard]] constexpr std::string_view altName() const noexcept { return m_altName; }
+        [[nodiscard]] constexpr std::string_view description() const noexcept { return m_description; }
+        [[nodiscard]] constexpr Type Parent::* field() const noexcept { return m_field; }
+        [[nodiscard]] constexpr std::string_view envName() const noexcept { return m_envName; }
+        [[nodiscard]] constexpr bool isRequired() const noexcept { return m_required; }
+
+        /// @brief Returns a copy of this option that falls back to the given environment variable.
+        [[nodiscard]] constexpr Option env(std::string_view envName) const noexcept {
+            Option copy = *this;
+            copy.m_envName = envName;
+            return copy;
+        }
+
+        /// @brief Returns a copy that must be given on the command line (or via its environment variable).
+        [[nodiscard]] constexpr Option required() const noexcept {
+            Option copy = *this;
+            copy.m_required = true;
+            return copy;
+        }
+
+        using Value = detail::field_value_t<T>;
+
+        // names in parentheses so that min/max macros (windows.h) don't expand here
+
+        /// @brief Returns a copy that rejects values below minimum.
+        [[nodiscard]] constexpr Option (min)(Value minimum) const noexcept requires detail::ordered_value<Value> {
+            Option copy = *this;
+            copy.m_constraints.minimum = minimum;
+            copy.m_constraints.hasMinimum = true;
+            return copy;
+        }
+
+        /// @brief Returns a copy that rejects values above maximum.
+        [[nodiscard]] constexpr Option (max)(Value maximum) const noexcept requires detail::ordered_value<Value> {
+            Option copy = *this;
+            copy.m_constraints.maximum = maximum;
+            copy.m_constraints.hasMaximum = true;
+            return copy;
+        }
+
+        /// @brief Returns a copy that rejects values outside [minimum, maximum].
+        [[nodiscard]] constexpr Option range(Value minimum, Value maximum) const noexcept requires detail::ordered_value<Value> {
+            auto copy = (this->min)(minimum);
+            return (copy.max)(maximum);
+        }
+
+        /// @brief Returns a copy that rejects empty strings.
+        [[nodiscard]] constexpr Option nonEmpty() const noexcept requires std::is_same_v<Value, std::string_view> {
+            Option copy = *this;
+            copy.m_constraints.nonEmpty = true;
+            return copy;
+        }
+
+        /// @brief Returns a copy that only accepts the given values (up to 8).
+        [[nodiscard]] constexpr Option oneOf(std::initializer_list<Value> values) const noexcept
+            requires detail::constrainable_value<Value> {
+            Option copy = *this;
+            copy.m_constraints.setChoices(values);
+            return copy;
+        }
+
+        [[nodiscard]] constexpr detail::constraints_t<Value> const& constraints() const noexcept { return m_constraints; }
+
+        [[nodiscard]] constexpr bool matches(std::string_view arg) const noexcept {
+            return arg == m_name || arg == m_altName;
+        }
+
+        [[nodiscard]] static constexpr bool needsValue() noexcept {
+            using Inner = detail::unwrap_optional_t<T>;
+            return !std::is_same_v<Inner, bool>;
+        }
+
+        [[nodiscard]] static constexpr bool isRepeatable() noexcept {
+            return detail::is_collect_v<T> || detail::is_collect_views_v<T>;
+        }
+
+    private:
+        std::string_view m_name{};
+        std::string_view m_altName{};
+        std::string_view m_description{};
+        std::string_view m_envName{};
+        T S::* m_field{};
+        bool m_required = false;
+        [[no_unique_address]] detail::constraints_t<Value> m_constraints{};
+    };
+
+    /// @brief Represents a positional argument (e.g., filename).
+    template <typename T, typename S>
+    struct Arg {
+        using Type = T;
+        using Parent = S;
+
+        constexpr Arg(std::string_view name, T S::* field) noexcept
+            : m_name(name), m_field(field) {}
+
+        constexpr Arg(std::string_view name, T S::* field, std::string_view description) noexcept
+            : m_name(name), m_description(description), m_field(field) {}
+
+        [[nodiscard]] constexpr std::string_view name() const noexcept { return m_name; }
+        [[nodiscard]] constexpr std::string_view description() const noexcept { return m_description; }
+        [[nodiscard]] constexpr Type Parent::* field() const noexcept { return m_field; }
+
+        [[nodiscard]] static consteval bool isOptional() noexcept {
+            return detail::is_optional_v<T>;
+        }
+
+        using Value = detail::field_value_t<T>;
+
+        /// @copydoc Option::min
+        [[nodiscard]] constexpr Arg (min)(Value minimum) const noexcept requires detail::ordered_value<Value> {
+            Arg copy = *this;
+            copy.m_constraints.minimum = minimum;
+            copy.m_constraints.hasMinimum = true;
+            return copy;
+        }
+
+        /// @copydoc Option::max
+        [[nodiscard]] constexpr Arg (max)(Value maximum) const noexcept requires detail::ordered_value<Value> {
+            Arg copy = *this;
+            copy.m_constraints.maximum = maximum;
+            copy.m_constraints.hasMaximum = true;
+            return copy;
+        }
+
+        /// @copydoc Option::range
+        [[nodiscard]] constexpr Arg range(Value minimum, Value maximum) const noexcept requires detail::ordered_value<Value> {
+            auto copy = (this->min)(minimum);
+            return (copy.max)(maximum);
+        }
+
+        /// @copydoc Option::nonEmpty
+        [[nodiscard]] constexpr Arg nonEmpty() const noexcept requires std::is_same_v<Value, std::string_view> {
+            Arg copy = *this;
+            copy.m_constraints.nonEmpty = true;
+            return copy;
+        }
+
+        /// @copydoc Option::oneOf
+        [[nodiscard]] constexpr Arg oneOf(std::initializer_list<Value> values) const noexcept
+            requires detail::constrainable_value<Value> {
+            Arg copy = *this;
+            copy.m_constraints.setChoices(values);
+            return copy;
+        }
+
+        [[nodiscard]] constexpr detail::constraints_t<Value> const& constraints() const noexcept { return m_constraints; }
+
+    private:
+        std::string_view m_name{};
+        std::string_view m_description{};
+        T S::* m_field{};
+        [[no_unique_address]] detail::constraints_t<Value> m_constraints{};
+    };
+
+    /// @brief Represents variadic arguments, that attaches to an ArgSpan or TypedArgSpan<T> field.
+    template <typename S, typename F = ArgSpan>
+    struct VarArgs {
+        static_assert(std::is_same_v<F, ArgSpan> || detail::is_typed_arg_span_v<F>,
+                      "VarArgs attach to ArgSpan or TypedArgSpan<T> fields");
+
+        using Type = F;
+        using Parent = S;
+
+        constexpr VarArgs(F S::* field) noexcept
+            : m_field(field) {}
+
+        constexpr VarArgs(std::string_view description, F S::* field) noexcept
+            : m_description(description), m_field(field) {}
+
+        [[nodiscard]] constexpr std::string_view description() const { return m_description; }
+        [[nodiscard]] constexpr Type Parent::* field() const noexcept { return m_field; }
+
+    private:
+        std::string_view m_description{};
+        F S::* m_field;
+    };
+
+    /// @brief A subcommand name, parsed into the options struct S.
+    template <typename S>
+    struct Command {
+        using Type = S;
+
+        constexpr Command(std::string_view name) noexcept
+            : m_name(name) {}
+
+        constexpr Command(std::string_view name, std::string_view description) noexcept
+            : m_name(name), m_description(description) {}
+
+        [[nodiscard]] constexpr std::string_view name() const noexcept { return m_name; }
+        [[nodiscard]] constexpr std::string_view description() const noexcept { return m_description; }
+
+    private:
+        std::string_view m_name{};
+        std::string_view m_description{};
+    };
+
+    /// @brief Represents git-style subcommands. The first positional argument selects the command,
+    /// and the rest of the arguments are parsed into its struct, stored in a variant field.
+    template <typename S, typename... C>
+    struct Subcommands {
+        using Type = std::variant<std::monostate, C...>;
+        using Parent = S;
+        using Commands = std::tuple<Command<C>...>;
+
+        constexpr Subcommands(Type S::* field, Command<C>... commands) noexcept
+            : m_field(field), m_commands(commands...) {}
+
+        [[nodiscard]] constexpr Type Parent::* field() const noexcept { return m_field; }
+        [[nodiscard]] constexpr Commands const& commands() const noexcept { return m_commands; }
+
+        [[nodiscard]] static consteval size_t count() noexcept { return sizeof...(C); }
+
+    private:
+        Type S::* m_field;
+        Commands m_commands;
+    };
+
+    namespace detail {
+        template <typename T>
+        struct is_option : std::false_type {};
+
+        template <typename T, typename S>
+        struct is_option<Option<T, S>> : std::true_type {};
+
+        template <typename T>
+        constexpr bool is_option_v = is_option<std::remove_cvref_t<T>>::value;
+
+        template <typename T>
+        struct is_arg : std::false_type {};
+
+        template <typename T, typename S>
+        struct is_arg<Arg<T, S>> : std::true_type {};
+
+        template <typename T>
         constexpr bool is_arg_v = is_arg<std::remove_cvref_t<T>>::value;
 
-        template <typename T>
-        struct is_varargs : std::false_type {};
+        template <typename T>
+        struct is_varargs : std::false_type {};
+
+        template <typename S, typename F>
+        struct is_varargs<VarArgs<S, F>> : std::true_type {};
+
+        template <typename T>
+        constexpr bool is_varargs_v = is_varargs<std::remove_cvref_t<T>>::value;
+
+        template <typename T>
+        struct is_subcommands : std::false_type {};
+
+        template <typename S, typename... C>
+        struct is_subcommands<Subcommands<S, C...>> : std::true_type {};
+
+        template <typename T>
+        constexpr bool is_subcommands_v = is_subcommands<std::remove_cvref_t<T>>::value;
+
+        /// @brief Reaching this function during constant evaluation makes the compilation fail.
+        inline void duplicate_option_name() noexcept {}
+
+        /// @brief Same, for options with an environment variable in a CompactArgParser.
+        inline void compact_parser_has_no_environment() noexcept {}
+
+        /// @brief FNV-1a hash, used by the compile-time name tables.
+        inline constexpr uint32_t HashBasis = 2166136261u;
+
+        constexpr uint32_t hashStep(uint32_t hash, char c) noexcept {
+            return (hash ^ static_cast<uint8_t>(c)) * 16777619u;
+        }
+
+        constexpr uint32_t hashName(std::string_view str) noexcept {
+            uint32_t hash = HashBasis;
+            for (char c : str) {
+                hash = hashStep(hash, c);
+            }
+            return hash;
+        }
+
+        /// @brief Slot of a NameIndex. Empty slots are all zeros, so they never depend on member initializers.
+        struct NameSlot {
+            static constexpr uint16_t npos = 0xFFFF;
+
+            std::string_view name{};
+            uint32_t hash = 0;
+            uint16_t entry = 0; ///< value + 1, or 0 if empty
+        };
+
+        /// @brief Linear probing lookup in a power-of-two sized slot table, npos if the name isn't there.
+        constexpr uint16_t findName(std::span<NameSlot const> slots, std::string_view name, uint32_t hash) noexcept {
+            size_t mask = slots.size() - 1;
+            size_t pos = hash & mask;
+            while (slots[pos].entry != 0) {
+                if (slots[pos].hash == hash && slots[pos].name == name) {
+                    return static_cast<uint16_t>(slots[pos].entry - 1);
+                }
+                pos = (pos + 1) & mask;
+            }
+            return NameSlot::npos;
+        }
+
+        /// @brief Looks up prefix + key without building the string, e.g. "--" and a config file key.
+        /// hash must be the hash of the whole name.
+        constexpr uint16_t findName(std::span<NameSlot const> slots, std::string_view prefix, std::string_view key,
+                                    uint32_t hash) noexcept {
+            size_t mask = slots.size() - 1;
+            size_t pos = hash & mask;
+            while (slots[pos].entry != 0) {
+                auto const& slot = slots[pos];
+                if (slot.hash == hash && slot.name.size() == prefix.size() + key.size() &&
+                    slot.name.starts_with(prefix) && slot.name.ends_with(key)) {
+                    return static_cast<uint16_t>(slot.entry - 1);
+                }
+                pos = (pos + 1) & mask;
+            }
+            return NameSlot::npos;
+        }
+
+        /// @brief Names in lexicographic order with the value of each, for prefix lookups and suggestions.
+        template <size_t N>
+        struct SortedNames {
+            std::array<std::string_view, N> names{};
+            std::array<uint16_t, N> values{};
+
+            constexpr void sort() noexcept {
+                for (size_t i = 1; i < N; ++i) {
+                    for (size_t j = i; j > 0 && names[j] < names[j - 1]; --j) {
+                        std::swap(names[j], names[j - 1]);
+                        std::swap(values[j], values[j - 1]);
+                    }
+                }
+            }
+        };
+
+        /// @brief findPrefix() result when the prefix starts names of different values.
+        inline constexpr uint16_t AmbiguousName = 0xFFFE;
+
+        /// @brief Position of the first of the sorted names that isn't less than name.
+        constexpr size_t lowerBound(std::span<std::string_view const> names, std::string_view name) noexcept {
+            size_t low = 0;
+            size_t high = names.size();
+            while (low < high) {
+                size_t mid = low + (high - low) / 2;
+                if (names[mid] < name) {
+                    low = mid + 1;
+                } else {
+                    high = mid;
+                }
+            }
+            return low;
+        }
+
+        /// @brief Value of the names starting with prefix, NameSlot::npos if there are none,
+        /// or AmbiguousName if they belong to different values.
+        constexpr uint16_t findPrefix(std::span<std::string_view const> names, std::span<uint16_t const> values,
+                                      std::string_view prefix) noexcept {
+            uint16_t found = NameSlot::npos;
+            for (size_t i = lowerBound(names, prefix); i < names.size() && names[i].starts_with(prefix); ++i) {
+                if (found != NameSlot::npos && values[i] != found) {
+                    return AmbiguousName;
+                }
+                found = values[i];
+            }
+            return found;
+        }
+
+        /// @brief Open-addressing hash table from names to indices, built at compile time.
+        /// Kept at most half full, so a lookup is a hash, ~1 probe and a single string compare.
+        template <size_t N>
+        struct NameIndex {
+            static constexpr uint16_t npos = NameSlot::npos;
+            static constexpr size_t Capacity = std::bit_ceil(N * 2 + 1);
+
+            constexpr void insert(std::string_view name, uint16_t value) noexcept {
+                uint32_t hash = hashName(name);
+                size_t pos = hash & (Capacity - 1);
+                while (m_slots[pos].entry != 0) {
+                    if (m_slots[pos].name == name) {
+                        duplicate_option_name();
+                    }
+                    pos = (pos + 1) & (Capacity - 1);
+                }
+                m_slots[pos] = {name, hash, static_cast<uint16_t>(value + 1)};
+            }
+
+            [[nodiscard]] constexpr uint16_t find(std::string_view name) const noexcept {
+                return find(name, hashName(name));
+            }
+
+            /// @brief Looks up a name whose hash is already known.
+            [[nodiscard]] constexpr uint16_t find(std::string_view name, uint32_t hash) const noexcept {
+                return findName(m_slots, name, hash);
+            }
+
+            /// @brief Looks up prefix + key, e.g. "--" and a config file key.
+            [[nodiscard]] constexpr uint16_t find(std::string_view prefix, std::string_view key) const noexcept {
+                uint32_t hash = HashBasis;
+                for (char c : prefix) hash = hashStep(hash, c);
+                for (char c : key) hash = hashStep(hash, c);
+                return findName(m_slots, prefix, key, hash);
+            }
+
+            [[nodiscard]] constexpr std::span<NameSlot const> slots() const noexcept { return m_slots; }
+
+        private:
+            std::array<NameSlot, Capacity> m_slots{};
+        };
+
+        template <typename E>
+        consteval auto buildEnumIndex() noexcept {
+            constexpr auto const& names = EnumTraits<E>::Names;
+            NameIndex<names.size()> index{};
+            for (size_t i = 0; i < names.size(); ++i) {
+                index.insert(names[i].first, static_cast<uint16_t>(i));
+            }
+            return index;
+        }
+
+        /// @brief Maps every name of E to its position in EnumTraits<E>::Names.
+        template <typename E>
+        struct EnumIndex {
+            static constexpr auto value = buildEnumIndex<E>();
+        };
+
+        /// @brief The names of E in declaration order, for completion.
+        template <typename E>
+        struct EnumNames {
+            static constexpr auto value = [] {
+                constexpr auto const& names = EnumTraits<E>::Names;
+                std::array<std::string_view, names.size()> result{};
+                for (size_t i = 0; i < names.size(); ++i) {
+                    result[i] = names[i].first;
+                }
+                return result;
+            }();
+        };
+
+        template <typename E>
+        constexpr std::optional<E> parseEnum(std::string_view input) noexcept {
+            constexpr auto const& index = EnumIndex<E>::value;
+            auto slot = index.find(input);
+            if (slot == index.npos) {
+                return std::nullopt;
+            }
+            return EnumTraits<E>::Names[slot].second;
+        }
+
+        /// @brief Fixed-size bitset with constexpr access, sized at compile time.
+        template <size_t N>
+        struct BitSet {
+            static constexpr size_t Words = (N + 63) / 64;
+
+            std::array<uint64_t, Words> words{};
+
+            constexpr void set(size_t idx) noexcept { words[idx / 64] |= uint64_t{1} << (idx % 64); }
+            [[nodiscard]] constexpr bool test(size_t idx) const noexcept {
+                return (words[idx / 64] >> (idx % 64)) & 1;
+            }
+
+            [[nodiscard]] constexpr bool subsetOf(BitSet const& other) const noexcept {
+                uint64_t missing = 0;
+                for (size_t i = 0; i < Words; ++i) {
+                    missing |= words[i] & ~other.words[i];
+                }
+                return missing == 0;
+            }
+
+            /// @brief Index of the first bit set here but not in other, or N.
+            [[nodiscard]] constexpr size_t firstMissingFrom(BitSet const& other) const noexcept {
+                for (size_t i = 0; i < Words; ++i) {
+                    if (uint64_t missing = words[i] & ~other.words[i]) {
+                        return i * 64 + static_cast<size_t>(std::countr_zero(missing));
+                    }
+                }
+                return N;
+            }
+        };
+
+        /// @brief A pre-classified token. Options also carry the offset of their first '=' (or NoEq)
+        /// and the hash of the name before it.
+        struct Token {
+            static constexpr uint32_t NoEq = UINT32_MAX;
+
+            std::string_view text;
+            uint32_t eq;
+            uint32_t hash;
+            TokenKind kind;
+        };
+
+        /// @brief Hashes an option name up to the first '=' in [str, end), recording where it is.
+        /// Without an end, the token ends at its terminating NUL.
+        /// @return Length of the name.
+        constexpr size_t scanOptionName(char const* str, char const* end, Token& token) noexcept {
+            uint32_t hash = HashBasis;
+            char const* pos = str;
+            for (; end ? pos != end : *pos != '\0'; ++pos) {
+                if (*pos == '=') break;
+                hash = hashStep(hash, *pos);
+            }
+
+            auto length = static_cast<size_t>(pos - str);
+            bool found = end ? pos != end : *pos != '\0';
+            token.hash = hash;
+            token.eq = found ? static_cast<uint32_t>(length) : Token::NoEq;
+            return length;
+        }
+
+        /// @brief Classifies a token by its first characters.
+        constexpr TokenKind tokenKind(std::string_view text) noexcept {
+            if (text.size() < 1 || text[0] != '-') return TokenKind::Positional;
+            if (text.size() < 2 || text[1] != '-') return TokenKind::Short;
+            return text.size() == 2 ? TokenKind::Separator : TokenKind::Long;
+        }
+
+        /// @brief Walks the arguments through a stack buffer of tokens, classified a chunk at a time,
+        /// so every argument is scanned once before dispatch.
+        class TokenCursor {
+        public:
+            static constexpr size_t ChunkSize = 8;
+
+            constexpr TokenCursor(ArgSpan args, size_t start) noexcept
+                : m_args(args), m_base(start) {}
+
+            /// @brief Returns the next token, or nullptr after the last one.
+            [[nodiscard]] constexpr Token const* next() noexcept {
+                if (m_pos == m_count && !refill()) {
+                    return nullptr;
+                }
+                return &m_chunk[m_pos++];
+            }
+
+            /// @brief Argument index of the last token returned by next().
+            [[nodiscard]] constexpr size_t index() const noexcept { return m_base + m_pos - 1; }
+
+        private:
+            constexpr bool refill() noexcept {
+                m_base += m_count;
+                m_pos = 0;
+                m_count = m_base < m_args.size() ? m_args.size() - m_base : 0;
+                m_count = m_count < ChunkSize ? m_count : ChunkSize;
+
+                for (size_t i = 0; i < m_count; ++i) {
+                    Token& token = m_chunk[i];
+                    token.eq = Token::NoEq;
+                    if (m_args.m_ptrs) {
+                        char const* str = m_args.m_ptrs[m_base + i];
+                        if (str[0] == '-') {
+                            size_t length = scanOptionName(str, nullptr, token);
+                            if (token.eq != Token::NoEq) {
+                                length += std::string_view{str + length}.size();
+                            }
+                            token.text = std::string_view{str, length};
+                        } else {
+                            token.text = str;
+                        }
+                    } else {
+                        token.text = m_args.m_views[m_base + i];
+                        if (token.text.starts_with('-')) {
+                            scanOptionName(token.text.data(), token.text.data() + token.text.size(), token);
+                        }
+                    }
+
+                    token.kind = tokenKind(token.text);
+                    if (token.kind == TokenKind::Separator) {
+                        // nothing after "--" is dispatched, so don't scan it
+                        m_count = i + 1;
+                        break;
+                    }
+                }
+                return m_count > 0;
+            }
+
+            ArgSpan m_args;
+            size_t m_base;
+            size_t m_count = 0;
+            size_t m_pos = 0;
+            std::array<Token, ChunkSize> m_chunk;
+        };
+
+        /// @brief Timestamp counter for the observer hooks, in cycles where available (nanoseconds otherwise).
+        constexpr uint64_t cycleCount() noexcept {
+            if (std::is_constant_evaluated()) {
+                return 0;
+            }
+        #if defined(_M_X64) || defined(_M_IX86)
+            return __rdtsc();
+        #elif defined(__x86_64__) || defined(__i386__)
+            return __builtin_ia32_rdtsc(); // <x86intrin.h> alone adds more than a second to every compile
+        #else
+            return static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+        #endif
+        }
+
+        /// @brief Returns the process environment block.
+        inline char const* const* environment() noexcept {
+        #if defined(_WIN32)
+            return _environ;
+        #else
+            return ::environ;
+        #endif
+        }
+
+        template <typename T>
+        constexpr bool completion_v = [] {
+            if constexpr (requires { T::Completion; }) {
+                return static_cast<bool>(T::Completion);
+            } else {
+                return false;
+            }
+        }();
+
+        template <typename T>
+        constexpr bool permute_v = [] {
+            if constexpr (requires { T::Permute; }) {
+                return static_cast<bool>(T::Permute);
+            } else {
+                return false;
+            }
+        }();
+
+        template <typename T>
+        constexpr bool abbreviations_v = [] {
+            if constexpr (requires { T::Abbreviations; }) {
+                return static_cast<bool>(T::Abbreviations);
+            } else {
+                return false;
+            }
+        }();
+
+        template <typename T>
+        constexpr bool config_files_v = [] {
+            if constexpr (requires { T::ConfigFiles; }) {
+                return static_cast<bool>(T::ConfigFiles);
+            } else {
+                return false;
+            }
+        }();
+
+        template <typename T>
+        constexpr bool response_files_v = [] {
+            if constexpr (requires { T::ResponseFiles; }) {
+                return static_cast<bool>(T::ResponseFiles);
+            } else {
+                return false;
+            }
+        }();
+
+        struct Empty {};
+
+        constexpr bool isSpace(char c) noexcept {
+            return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f' || c == '\0';
+        }
+
+        constexpr std::string_view trimSpaces(std::string_view text) noexcept {
+            while (!text.empty() && isSpace(text.front())) text.remove_prefix(1);
+            while (!text.empty() && isSpace(text.back())) text.remove_suffix(1);
+            return text;
+        }
+
+        /// @brief Returns true for bytes that end an unquoted run: whitespace, quotes and backslashes.
+        constexpr bool isSpecial(char c) noexcept {
+            return isSpace(c) || c == '"' || c == '\'' || c == '\\';
+        }
+
+    #if SLIC_HAS_SSE2
+        /// @brief Skips 16-byte blocks without special bytes, returns the first special byte
+        /// or the start of the remaining tail.
+        inline char const* findSpecialSse2(char const* in, char const* end) noexcept {
+            __m128i const space = _mm_set1_epi8(' ');
+            __m128i const dquote = _mm_set1_epi8('"');
+            __m128i const squote = _mm_set1_epi8('\'');
+            __m128i const backslash = _mm_set1_epi8('\\');
+
+            while (end - in >= 16) {
+                __m128i chunk = _mm_loadu_si128(reinterpret_cast<__m128i const*>(in));
+                // every byte <= ' ' is a candidate, control characters are filtered below
+                __m128i mask = _mm_cmpeq_epi8(_mm_min_epu8(chunk, space), chunk);
+                mask = _mm_or_si128(mask, _mm_cmpeq_epi8(chunk, dquote));
+                mask = _mm_or_si128(mask, _mm_cmpeq_epi8(chunk, squote));
+                mask = _mm_or_si128(mask, _mm_cmpeq_epi8(chunk, backslash));
+
+                auto bits = static_cast<unsigned>(_mm_movemask_epi8(mask));
+                for (; bits != 0; bits &= bits - 1) {
+                    char const* pos = in + std::countr_zero(bits);
+                    if (isSpecial(*pos)) return pos;
+                }
+                in += 16;
+            }
+            return in;
+        }
+    #endif
+
+        /// @brief Returns the first special byte in [in, end), or end.
+        constexpr char const* findSpecial(char const* in, char const* end) noexcept {
+        #if SLIC_HAS_SSE2
+            if (!std::is_constant_evaluated()) {
+                in = findSpecialSse2(in, end);
+            }
+        #endif
+            while (in < end && !isSpecial(*in)) ++in;
+            return in;
+        }
+
+        /// @brief Copies one token from [in, end) to out, resolving quotes and backslash escapes,
+        /// up to the first unquoted whitespace. out may alias the input, as it never overtakes it.
+        /// @return End of the consumed input, or nullptr if the token doesn't fit before outEnd.
+        constexpr char const* unescapeToken(char const* in, char const* end, char*& out, char const* outEnd) noexcept {
+            char quote = 0;
+            while (in < end) {
+                char c = *in;
+                if (quote == 0 && !isSpecial(c)) {
+                    char const* run = findSpecial(in, end);
+                    auto length = static_cast<size_t>(run - in);
+                    if (static_cast<size_t>(outEnd - out) < length) return nullptr;
+                    if (out != in) {
+                        for (size_t i = 0; i < length; ++i) out[i] = in[i];
+                    }
+                    out += length;
+                    in = run;
+                    continue;
+                }
+                if (quote == 0 && isSpace(c)) break;
+
+                if (quote == '\'' && c == quote) {
+                    quote = 0;
+                } else if (quote != '\'' && c == '\\' && in + 1 < end) {
+                    if (out == outEnd) return nullptr;
+                    *out++ = in[1];
+                    ++in;
+                } else if (quote == '"' && c == quote) {
+                    quote = 0;
+                } else if (quote == 0 && (c == '"' || c == '\'')) {
+                    quote = c;
+                } else {
+                    if (out == outEnd) return nullptr;
+                    *out++ = c;
+                }
+                ++in;
+            }
+            return in;
+        }
+
+        /// @brief Splits [begin, end) into whitespace-separated tokens in place, packing them
+        /// as consecutive NUL-terminated strings starting at `begin`. Handles single and double
+        /// quotes and backslash escapes. `*end` must be writable.
+        /// @return Number of tokens.
+        inline size_t packTokens(char* begin, char* end) noexcept {
+            char* in = begin;
+            char* out = begin;
+            size_t count = 0;
+
+            while (true) {
+                while (in < end && isSpace(*in)) ++in;
+                if (in >= end) break;
+
+                in = begin + (unescapeToken(in, end, out, end) - begin);
+
+                // the output never overtakes the input, so this overwrites
+                // at most the separator (or the byte past the end)
+                *out++ = '\0';
+                ++count;
+                if (in < end) ++in;
+            }
+
+            return count;
+        }
+
+        /// @brief Private, writable mapping of a file, followed by one extra zero byte.
+        class MappedFile {
+        public:
+            MappedFile() noexcept = default;
+            MappedFile(MappedFile const&) = delete;
+            MappedFile& operator=(MappedFile const&) = delete;
+
+            MappedFile(MappedFile&& other) noexcept
+                : m_data(std::exchange(other.m_data, nullptr)), m_size(std::exchange(other.m_size, 0)) {}
+
+            MappedFile& operator=(MappedFile&& other) noexcept {
+                if (this != &other) {
+                    reset();
+                    m_data = std::exchange(other.m_data, nullptr);
+                    m_size = std::exchange(other.m_size, 0);
+                }
+                return *this;
+            }
+
+            ~MappedFile() { reset(); }
+
+            /// @brief Maps the file copy-on-write, so it can be modified without touching the file.
+            bool open(char const* path) noexcept {
+                reset();
+            #if defined(_WIN32)
+                std::FILE* file = std::fopen(path, "rb");
+                if (!file) return false;
+                if (std::fseek(file, 0, SEEK_END) != 0) { std::fclose(file); return false; }
+                long size = std::ftell(file);
+                if (size < 0 || std::fseek(file, 0, SEEK_SET) != 0) { std::fclose(file); return false; }
+                m_size = static_cast<size_t>(size);
+                m_data = new char[m_size + 1]{};
+                bool ok = std::fread(m_data, 1, m_size, file) == m_size;
+                std::fclose(file);
+                if (!ok) reset();
+                return ok;
+            #else
+                int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+                if (fd < 0) return false;
+
+                struct stat st{};
+                if (::fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+                    ::close(fd);
+                    return false;
+                }
+
+                // reserve one byte more than the file, then map the file over the start of it:
+                // the byte past the end is always zeroed memory, even on a page boundary
+                size_t size = static_cast<size_t>(st.st_size);
+                void* base = ::mmap(nullptr, size + 1, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+                if (base == MAP_FAILED) {
+                    ::close(fd);
+                    return false;
+                }
+
+                if (size > 0 && ::mmap(base, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, fd, 0) == MAP_FAILED) {
+                    ::munmap(base, size + 1);
+                    ::close(fd);
+                    return false;
+                }
+
+                ::close(fd);
+                m_data = static_cast<char*>(base);
+                m_size = size;
+                return true;
+            #endif
+            }
+
+            [[nodiscard]] char* data() const noexcept { return m_data; }
+            [[nodiscard]] size_t size() const noexcept { return m_size; }
+
+        private:
+            void reset() noexcept {
+                if (!m_data) return;
+            #if defined(_WIN32)
+                delete[] m_data;
+            #else
+                ::munmap(m_data, m_size + 1);
+            #endif
+                m_data = nullptr;
+                m_size = 0;
+            }
+
+            char* m_data = nullptr;
+            size_t m_size = 0;
+        };
+
+        /// @brief Storage for an argv with its @file arguments expanded in place.
+        class ResponseFiles {
+        public:
+            /// @brief Expands every @file argument before the first "--".
+            /// @return Index of the argument that couldn't be read, or -1.
+            int expand(ArgSpan args) noexcept {
+                m_files.clear();
+                m_counts.clear();
+                m_args.clear();
+
+                size_t total = 0;
+                size_t end = args.size();
+                for (size_t i = 1; i < args.size(); ++i) {
+                    std::string_view arg = args[i];
+                    if (arg == "--") {
+                        end = i;
+                        break;
+                    }
+                    if (arg.size() > 1 && arg.front() == '@') {
+                        MappedFile file;
+                        if (!file.open(std::string{arg.substr(1)}.c_str())) {
+                            m_files.clear();
+                            m_counts.clear();
+                            return static_cast<int>(i);
+                        }
+                        m_counts.push_back(packTokens(file.data(), file.data() + file.size()));
+                        total += m_counts.back();
+                        m_files.push_back(std::move(file));
+                    }
+                }
+
+                if (m_files.empty()) {
+                    return -1;
+                }
+
+                m_args.reserve(args.size() - m_files.size() + total);
+                size_t fileIdx = 0;
+                for (size_t i = 0; i < args.size(); ++i) {
+                    std::string_view arg = args[i];
+                    if (i == 0 || i >= end || arg.size() <= 1 || arg.front() != '@') {
+                        m_args.push_back(arg);
+                        continue;
+                    }
+
+                    char const* token = m_files[fileIdx].data();
+                    for (size_t n = m_counts[fileIdx]; n > 0; --n) {
+                        std::string_view view{token};
+                        m_args.push_back(view);
+                        token += view.size() + 1;
+                    }
+                    ++fileIdx;
+                }
+
+                m_counts.clear();
+                return -1;
+            }
+
+            /// @brief Releases the mapped files, keeping the storage for the next expansion.
+            void reset() noexcept {
+                m_files.clear();
+                m_args.clear();
+            }
+
+            [[nodiscard]] bool expanded() const noexcept { return !m_files.empty(); }
+            [[nodiscard]] ArgSpan args() const noexcept { return std::span<std::string_view const>{m_args}; }
+
+        private:
+            std::vector<MappedFile> m_files;
+            std::vector<size_t> m_counts;
+            std::vector<std::string_view> m_args;
+        };
+
+        /// @brief Appends text into a buffer, or only measures it when no buffer is given.
+        struct TextBuilder {
+            char* out = nullptr;
+            size_t size = 0;
+
+            constexpr TextBuilder& operator<<(std::string_view text) noexcept {
+                if (out) {
+                    for (size_t i = 0; i < text.size(); ++i) {
+                        out[size + i] = text[i];
+                    }
+                }
+                size += text.size();
+                return *this;
+            }
+
+            constexpr TextBuilder& operator<<(char c) noexcept {
+                return *this << std::string_view{&c, 1};
+            }
+        };
+
+        /// @brief Writes a number in decimal, floating point ones with up to 6 decimals, or like 1.5e20
+        /// when that would print nothing but zeros or not fit 64 bits.
+        template <typename V>
+        constexpr void appendNumber(TextBuilder& out, V value) noexcept {
+            if constexpr (std::is_floating_point_v<V>) {
+                if (value != value) {
+                    out << "nan";
+                    return;
+                }
+            }
+            if (value < 0) {
+                out << '-';
+            }
+            if constexpr (std::is_integral_v<V>) {
+                auto magnitude = static_cast<std::make_unsigned_t<V>>(value);
+                if (value < 0) {
+                    magnitude = static_cast<std::make_unsigned_t<V>>(0 - magnitude);
+                }
+                char digits[20]{};
+                size_t count = 0;
+                do {
+                    digits[count++] = static_cast<char>('0' + magnitude % 10);
+                    magnitude /= 10;
+                } while (magnitude);
+                while (count) out << digits[--count];
+            } else {
+                auto magnitude = value < 0 ? -value : value;
+                if (magnitude > std::numeric_limits<V>::max()) {
+                    out << "inf";
+                    return;
+                }
+                if (magnitude >= V(1e12) || (magnitude > 0 && magnitude < V(1e-4))) {
+                    // scientific, the mantissa in [1, 10) takes the plain path below
+                    int exponent = 0;
+                    long double mantissa = magnitude;
+                    for (; mantissa >= 10; mantissa /= 10) ++exponent;
+                    for (; mantissa < 1; mantissa *= 10) --exponent;
+                    if (mantissa >= 9.9999995L) { // would round up to 10
+                        mantissa = 1;
+                        ++exponent;
+                    }
+                    appendNumber(out, static_cast<double>(mantissa));
+                    out << 'e';
+                    appendNumber(out, exponent);
+                    return;
+                }
+                auto scaled = static_cast<unsigned long long>(magnitude * 1'000'000 + V(0.5));
+                appendNumber(out, scaled / 1'000'000);
+                auto fraction = scaled % 1'000'000;
+                if (fraction) {
+                    char digits[7] = {'.', '0', '0', '0', '0', '0', '0'};
+                    size_t end = 7;
+                    for (size_t i = 6; i > 0; --i, fraction /= 10) {
+                        digits[i] = static_cast<char>('0' + fraction % 10);
+                    }
+                    while (digits[end - 1] == '0') --end;
+                    out << std::string_view{digits, end};
+                }
+            }
+        }
+
+        /// @brief Describes constraints like " [range: 1..256]", as shown in help and errors.
+        template <typename C>
+        constexpr void renderConstraints(TextBuilder& out, C const& constraints) noexcept {
+            if constexpr (requires { requires std::is_arithmetic_v<decltype(constraints.minimum)>; }) {
+                if (constraints.hasMinimum && constraints.hasMaximum) {
+                    out << " [range: ";
+                    appendNumber(out, constraints.minimum);
+                    out << "..";
+                    appendNumber(out, constraints.maximum);
+                    out << ']';
+                } else if (constraints.hasMinimum) {
+                    out << " [min: ";
+                    appendNumber(out, constraints.minimum);
+                    out << ']';
+                } else if (constraints.hasMaximum) {
+                    out << " [max: ";
+                    appendNumber(out, constraints.maximum);
+                    out << ']';
+                }
+            }
+            if constexpr (!std::is_same_v<C, NoConstraints>) {
+                if (constraints.nonEmpty) {
+                    out << " [non-empty]";
+                }
+                if (constraints.choiceCount > 0) {
+                    out << " [one of: ";
+                    for (size_t i = 0; i < constraints.choiceCount; ++i) {
+                        if (i > 0) out << ", ";
+                        if constexpr (std::is_arithmetic_v<std::remove_cvref_t<decltype(constraints.choices[i])>>) {
+                            appendNumber(out, constraints.choices[i]);
+                        } else {
+                            out << constraints.choices[i];
+                        }
+                    }
+                    out << ']';
+                }
+            }
+        }
+
+        /// @brief "<name> [constraints]" of entry I of T::Options, the context of a value that violates them.
+        template <class T, size_t I>
+        struct ConstraintError {
+            static constexpr void render(TextBuilder& out) noexcept {
+                constexpr auto const& entry = std::get<I>(T::Options);
+                out << entry.name();
+                renderConstraints(out, entry.constraints());
+            }
+
+            static consteval size_t size() noexcept {
+                TextBuilder counter;
+                render(counter);
+                return counter.size;
+            }
+
+            static constexpr auto text = [] {
+                std::array<char, size()> data{};
+                TextBuilder out{data.data()};
+                render(out);
+                return data;
+            }();
+
+            [[nodiscard]] static constexpr std::string_view view() noexcept { return {text.data(), text.size()}; }
+        };
+    } // namespace detail
+
+    /// @brief Splits a command line into shell-style tokens, handling quotes and backslash escapes.
+    /// Plain tokens are views into the source, only quoted or escaped ones are rewritten into scratch.
+    class Tokenizer {
+    public:
+        /// @brief A scratch buffer as large as the source is always enough.
+        constexpr Tokenizer(std::span<std::string_view> tokens, std::span<char> scratch) noexcept
+            : m_tokens(tokens), m_scratch(scratch) {}
+
+        /// @brief Tokenizes source, replacing the previous tokens.
+        /// @return false if the tokens don't fit the buffers.
+        [[nodiscard]] constexpr bool tokenize(std::string_view source) noexcept {
+            m_count = 0;
+            char* out = m_scratch.data();
+            char const* outEnd = m_scratch.data() + m_scratch.size();
+            char const* in = source.data();
+            char const* end = source.data() + source.size();
+
+            while (true) {
+                while (in < end && detail::isSpace(*in)) ++in;
+                if (in >= end) return true;
+                if (m_count == m_tokens.size()) return false;
+
+                char const* run = detail::findSpecial(in, end);
+                if (run == end || detail::isSpace(*run)) {
+                    m_tokens[m_count++] = std::string_view{in, static_cast<size_t>(run - in)};
+                    in = run;
+                    continue;
+                }
+
+                if (run == in && (*in == '"' || *in == '\'')) {
+                    // a quoted token without escapes is a view between the quotes
+                    char const* close = in + 1;
+                    while (close < end && *close != *in && (*in == '\'' || *close != '\\')) ++close;
+                    if (close < end && *close == *in && (close + 1 == end || detail::isSpace(close[1]))) {
+                        m_tokens[m_count++] = std::string_view{in + 1, static_cast<size_t>(close - in - 1)};
+                        in = close + 1;
+                        continue;
+                    }
+                }
+
+                char* first = out;
+                in = detail::unescapeToken(in, end, out, outEnd);
+                if (!in) return false;
+                m_tokens[m_count++] = std::string_view{first, static_cast<size_t>(out - first)};
+            }
+        }
+
+        [[nodiscard]] constexpr ArgSpan tokens() const noexcept {
+            return std::span<std::string_view const>{m_tokens.data(), m_count};
+        }
+
+        [[nodiscard]] constexpr size_t size() const noexcept { return m_count; }
+
+    private:
+        std::span<std::string_view> m_tokens;
+        std::span<char> m_scratch;
+        size_t m_count = 0;
+    };
+
+    /// @brief Shells that completion scripts can be generated for.
+    enum class Shell { Bash, Zsh, Fish };
+
+    template <>
+    struct EnumTraits<Shell> {
+        static constexpr std::array Names = {
+            std::pair{"bash", Shell::Bash}, std::pair{"zsh", Shell::Zsh}, std::pair{"fish", Shell::Fish}
+        };
+    };
+
+    namespace detail {
+        /// @brief Appends a script that completes program by running `program --complete <words>`,
+        /// falling back to file names when it prints nothing.
+        inline void appendCompletionScript(Shell shell, std::string_view program, std::string& out) {
+            std::string function = "_slic_complete_";
+            for (char c : program) {
+                bool word = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9');
+                function += word ? c : '_';
+            }
+
+            auto append = [&](std::initializer_list<std::string_view> parts) {
+                for (auto part : parts) out += part;
+            };
+            switch (shell) {
+                case Shell::Bash:
+                    append({function, "() {\n"
+                            "    local IFS=$'\\n'\n"
+                            "    COMPREPLY=($(", program, " --complete \"${COMP_WORDS[@]:1:COMP_CWORD}\" 2>/dev/null))\n"
+                            "}\n"
+                            "complete -o default -F ", function, " ", program, "\n"});
+                    break;
+                case Shell::Zsh:
+                    append({"#compdef ", program, "\n",
+                            function, "() {\n"
+                            "    local -a candidates\n"
+                            "    candidates=(${(f)\"$(", program, " --complete \"${(@)words[2,CURRENT]}\" 2>/dev/null)\"})\n"
+                            "    if (( ${#candidates} )); then\n"
+                            "        compadd -Q -- $candidates\n"
+                            "    else\n"
+                            "        _files\n"
+                            "    fi\n"
+                            "}\n"
+                            "compdef ", function, " ", program, "\n"});
+                    break;
+                case Shell::Fish:
+                    append({"function ", function, "\n"
+                            "    set -l words (commandline -opc)\n"
+                            "    ", program, " --complete $words[2..-1] (commandline -ct) 2>/dev/null\n"
+                            "end\n"
+                            "complete -c ", program, " -a '(", function, ")'\n"});
+                    break;
+            }
+        }
+    }
+
+    /// @brief Help message split around the program name, which is only known at runtime.
+    struct HelpText {
+        std::string_view prefix;
+        std::string_view programName;
+        std::string_view body;
+
+        [[nodiscard]] constexpr size_t size() const noexcept {
+            return prefix.size() + programName.size() + body.size();
+        }
+    };
+
+    /// @brief Default parser observer, every hook is a no-op. Custom observers can derive from it
+    /// and hide only the hooks they need. onToken sees the tokens the parser dispatches on (values taken
+    /// by an option only reach onValue). argIndex is SIZE_MAX for values from the environment.
+    struct NoObserver {
+        constexpr void onToken(size_t /*argIndex*/, TokenKind /*kind*/, std::string_view /*text*/) noexcept {}
+        constexpr void onOption(size_t /*argIndex*/, size_t /*optionIndex*/, std::string_view /*name*/) noexcept {}
+        constexpr void onValue(size_t /*argIndex*/, std::string_view /*value*/, bool /*ok*/, uint64_t /*cycles*/) noexcept {}
+        constexpr void onError(size_t /*argIndex*/, ParseResult const& /*result*/) noexcept {}
+    };
+
+    /// @brief Observer counting tokens, option matches (by tuple index of T::Options) and value conversions.
+    /// Meant for parsers without subcommands: a subcommand's options index a different tuple.
+    template <class T>
+    struct CountingObserver : NoObserver {
+        static constexpr size_t TupleSize = std::tuple_size_v<decltype(T::Options)>;
+
+        std::array<uint32_t, TupleSize> hits{};
+        uint32_t tokens = 0;
+        uint32_t values = 0;
+        uint32_t errors = 0;
+        uint64_t valueCycles = 0;
+
+        constexpr void onToken(size_t, TokenKind, std::string_view) noexcept { ++tokens; }
+        constexpr void onOption(size_t, size_t optionIndex, std::string_view) noexcept {
+            if (optionIndex < TupleSize) ++hits[optionIndex];
+        }
+        constexpr void onValue(size_t, std::string_view, bool, uint64_t cycles) noexcept {
+            ++values;
+            valueCycles += cycles;
+        }
+        constexpr void onError(size_t, ParseResult const&) noexcept { ++errors; }
+
+        /// @brief Number of times the option with the given name (or alternative name) was matched.
+        [[nodiscard]] constexpr uint32_t hitsFor(std::string_view name) const noexcept {
+            uint32_t count = 0;
+            [&]<size_t... I>(std::index_sequence<I...>) {
+                ([&] {
+                    if constexpr (detail::is_option_v<std::tuple_element_t<I, decltype(T::Options)>>) {
+                        if (std::get<I>(T::Options).matches(name)) count = hits[I];
+                    }
+                }(), ...);
+            }(std::make_index_sequence<TupleSize>());
+            return count;
+        }
+
+        constexpr void reset() noexcept { *this = CountingObserver{}; }
+    };
+
+    /// @brief Command-line argument parser for a given options struct T.
+    /// Observer receives a callback at every parsing step, see NoObserver.
+    template <class T, class Observer = NoObserver>
+    class ArgParser {
+    private:
+        using OptsT = decltype(T::Options);
+        static constexpr size_t TupleSize = std::tuple_size_v<OptsT>;
+        static_assert(TupleSize < 0xFFFF, "Too many entries in Options");
+
+    public:
+        constexpr ArgParser(int argc, char const* const* argv) noexcept {
+            bind(std::span{argv, static_cast<size_t>(argc)});
+        }
+
+        /// @brief Creates a parser over args, where args[0] is the program name.
+        constexpr explicit ArgParser(ArgSpan args) noexcept {
+            bind(args);
+        }
+
+        /// @brief Creates a parser without arguments, to be used with parse(args).
+        constexpr ArgParser() noexcept = default;
+
+        static consteval size_t optionCount() noexcept {
+            size_t count = 0;
+            [&]<size_t... I>(std::index_sequence<I...>) {
+                ((detail::is_option_v<std::tuple_element_t<I, OptsT>> ? ++count : 0), ...);
+            }(std::make_index_sequence<TupleSize>());
+            return count;
+        }
+
+        static consteval size_t argumentCount() noexcept {
+            size_t count = 0;
+            [&]<size_t... I>(std::index_sequence<I...>) {
+                ((detail::is_arg_v<std::tuple_element_t<I, OptsT>> ? ++count : 0), ...);
+            }(std::make_index_sequence<TupleSize>());
+            return count;
+        }
+
+        static consteval bool hasVarArgs() noexcept {
+            bool found = false;
+            [&]<size_t... I>(std::index_sequence<I...>) {
+                ((detail::is_varargs_v<std::tuple_element_t<I, OptsT>> ? (found = true) : false), ...);
+            }(std::make_index_sequence<TupleSize>());
+            return found;
+        }
+
+        static consteval size_t varArgsIndex() noexcept {
+            static_assert(hasVarArgs(), "Index is only accessible if varargs exist");
+            size_t count = 0;
+            [&]<size_t... I>(std::index_sequence<I...>) {
+                ((detail::is_varargs_v<std::tuple_element_t<I, OptsT>> ? (count = I) : false), ...);
+            }(std::make_index_sequence<TupleSize>());
+            return count;
+        }
+
+        static consteval bool hasSubcommands() noexcept {
+            bool found = false;
+            [&]<size_t... I>(std::index_sequence<I...>) {
+                ((detail::is_subcommands_v<std::tuple_element_t<I, OptsT>> ? (found = true) : false), ...);
+            }(std::make_index_sequence<TupleSize>());
+            return found;
+        }
+
+        static consteval size_t subcommandsIndex() noexcept {
+            static_assert(hasSubcommands(), "Index is only accessible if subcommands exist");
+            size_t count = 0;
+            [&]<size_t... I>(std::index_sequence<I...>) {
+                ((detail::is_subcommands_v<std::tuple_element_t<I, OptsT>> ? (count = I) : false), ...);
+            }(std::make_index_sequence<TupleSize>());
+            return count;
+        }
+
+        /// @brief Tuple index of the Option, Arg or VarArgs that stores into Field, or TupleSize.
+        template <auto Field>
+        static consteval size_t fieldIndex() noexcept {
+            size_t index = TupleSize;
+            [&]<size_t... I>(std::index_sequence<I...>) {
+                ([&] {
+                    using E = std::tuple_element_t<I, OptsT>;
+                    if constexpr (!detail::is_subcommands_v<E>) {
+                        if constexpr (std::is_same_v<decltype(std::get<I>(T::Options).field()), decltype(Field)>) {
+                            if (std::get<I>(T::Options).field() == Field) index = I;
+                        }
+                    }
+                }(), ...);
+            }(std::make_index_sequence<TupleSize>());
+            return index;
+        }
+
+        [[nodiscard]] constexpr T const& result() const noexcept { return m_options; }
+
+        [[nodiscard]] constexpr Observer& observer() noexcept { return m_observer; }
+        [[nodiscard]] constexpr Observer const& observer() const noexcept { return m_observer; }
+        [[nodiscard]] constexpr T& result() noexcept { return m_options; }
+        [[nodiscard]] constexpr std::string_view programName() const noexcept { return m_programName; }
+
+        /// @brief Whether the last parse stored into Field, from argv, the environment or a config file.
+        /// Lets plain fields stand in for std::optional ones; the check is a single bit test.
+        template <auto Field>
+        [[nodiscard]] constexpr bool isSet() const noexcept {
+            constexpr size_t index = fieldIndex<Field>();
+            static_assert(index < TupleSize, "No Option, Arg or VarArgs stores into this field");
+            return m_seen.test(index);
+        }
+
+        /// @brief Resets the result to its defaults and parses args (including the program name).
+        [[nodiscard]] constexpr ParseResult parse(std::span<char const* const> args) noexcept {
+            return parse(ArgSpan{args});
+        }
+
+        /// @copydoc parse(std::span<char const* const>)
+        [[nodiscard]] constexpr ParseResult parse(ArgSpan args) noexcept {
+            reset(args);
+            return parse();
+        }
+
+        /// @brief Splits line into tokens with tokenizer and parses them, the first token being the program name.
+        /// String results point into line or the tokenizer's scratch buffer.
+        [[nodiscard]] constexpr ParseResult parseString(std::string_view line, Tokenizer& tokenizer) noexcept {
+            if (!tokenizer.tokenize(line)) {
+                return ParseResult::failure(ParseError::TooManyTokens);
+            }
+            return parse(tokenizer.tokens());
+        }
+
+        /// @brief Parses every input with this parser, storing the result and status of inputs[i] at index i.
+        /// @return Number of inputs that parsed successfully.
+        constexpr size_t parseBatch(std::span<std::span<char const* const> const> inputs,
+                                    std::span<T> outputs, std::span<ParseResult> results) noexcept {
+            static_assert(!detail::response_files_v<T>, "Response file tokens only live until the next parse");
+
+            size_t count = inputs.size();
+            count = outputs.size() < count ? outputs.size() : count;
+            count = results.size() < count ? results.size() : count;
+            size_t succeeded = 0;
+            for (size_t i = 0; i < count; ++i) {
+                results[i] = parse(inputs[i]);
+                if (results[i].isOk()) {
+                    ++succeeded;
+                }
+                outputs[i] = std::move(m_options);
+            }
+            return succeeded;
+        }
+
+        [[nodiscard]] constexpr ParseResult parse() noexcept {
+            size_t positionalCount = 0;
+            auto result = parseTokens(positionalCount);
+            if (!result.isOk()) {
+                return result;
+            }
+            result = parseSubcommand(nullptr);
+            if (!result.isOk()) {
+                return result;
+            }
+            return report(checkRequired(positionalCount), NoArgIndex);
+        }
+
+        /// @brief Input range over the positional arguments left over once the declared Args are filled,
+        /// which parses the options around them as it is iterated. See positionals().
+        class PositionalRange {
+        public:
+            struct Sentinel {};
+
+            class iterator {
+            public:
+                using value_type = std::string_view;
+                using difference_type = std::ptrdiff_t;
+
+                constexpr iterator() noexcept = default;
+
+                constexpr std::string_view operator*() const noexcept { return m_range->m_current; }
+                constexpr iterator& operator++() noexcept { m_range->advance(); return *this; }
+                constexpr void operator++(int) noexcept { m_range->advance(); }
+                constexpr bool operator==(Sentinel) const noexcept { return m_range->m_done; }
+
+            private:
+                friend class PositionalRange;
+                constexpr explicit iterator(PositionalRange* range) noexcept : m_range(range) {}
+
+                PositionalRange* m_range = nullptr;
+            };
+
+            /// @brief Parses up to the first positional. Call once, the range is single-pass.
+            [[nodiscard]] constexpr iterator begin() noexcept {
+                if (!m_started) {
+                    m_started = true;
+                    advance();
+                }
+                return iterator{this};
+            }
+            [[nodiscard]] constexpr Sentinel end() const noexcept { return {}; }
+
+            /// @brief Argument index of the current positional.
+            [[nodiscard]] constexpr size_t index() const noexcept { return m_parser->argvIndex(m_tokens.index()); }
+
+            /// @brief Outcome of the parse once iteration stopped: an error ends the range early,
+            /// and required options and Args are checked after the last argument.
+            [[nodiscard]] constexpr ParseResult const& result() const noexcept { return m_result; }
+
+        private:
+            friend class ArgParser;
+
+            constexpr PositionalRange(ArgParser* parser, ParseResult result) noexcept
+                : m_parser(parser), m_tokens(parser->m_args, 1), m_result(result), m_done(!result.isOk()) {}
+
+            constexpr void advance() noexcept {
+                if (m_done) {
+                    return;
+                }
+                while (auto const* token = m_tokens.next()) {
+                    if constexpr (Observed) {
+                        m_parser->m_observer.onToken(index(), token->kind, token->text);
+                    }
+                    if (!m_rest && token->kind == TokenKind::Separator) {
+                        m_rest = true;
+                        continue;
+                    }
+
+                    ParseResult result;
+                    if (!m_rest && token->kind != TokenKind::Positional) {
+                        result = m_parser->tryParseOption(*token, m_tokens);
+                    } else if (m_positionalIndex < ArgCount) {
+                        result = m_parser->tryParsePositional(token->text, m_positionalIndex++, m_tokens.index());
+                    } else {
+                        m_current = token->text;
+                        return;
+                    }
+                    if (!result.isOk()) {
+                        finish(m_parser->report(result, m_tokens.index()));
+                        return;
+                    }
+                }
+                finish(m_parser->report(m_parser->checkRequired(m_positionalIndex), NoArgIndex));
+            }
+
+            constexpr void finish(ParseResult result) noexcept {
+                m_result = result;
+                m_current = {};
+                m_done = true;
+            }
+
+            ArgParser* m_parser;
+            detail::TokenCursor m_tokens;
+            ParseResult m_result;
+            std::string_view m_current;
+            size_t m_positionalIndex = 0;
+            bool m_rest = false;
+            bool m_started = false;
+            bool m_done;
+        };
+
+        /// @brief Parses incrementally: the declared Args are filled as usual, and every further positional
+        /// (what VarArgs would capture) is yielded as soon as it is reached, so work on it can start while
+        /// the rest of argv is scanned. Options are parsed up to `--` even after the first yielded value,
+        /// and the VarArgs field stays empty. Check result() on the range after iterating.
+        /// The range refers to the parser and must not outlive it.
+        [[nodiscard]] constexpr PositionalRange positionals() noexcept {
+            static_assert(!hasSubcommands(), "positionals() doesn't support subcommands");
+            return PositionalRange(this, expandResponseFiles());
+        }
+
+        /// @brief Parses the arguments, then fills options that weren't given from their environment variables.
+        /// @param envp Environment block, as passed to main (defaults to the process environment).
+        [[nodiscard]] ParseResult parseWithEnv(char const* const* envp = detail::environment()) noexcept {
+            size_t positionalCount = 0;
+            auto result = parseTokens(positionalCount);
+            if (!result.isOk()) {
+                return result;
+            }
+            result = applyEnvironment(envp);
+            if (!result.isOk()) {
+                return report(result, NoArgIndex);
+            }
+            result = parseSubcommand(envp);
+            if (!result.isOk()) {
+                return result;
+            }
+            return report(checkRequired(positionalCount), NoArgIndex);
+        }
+
+        /// @brief Parses the arguments, then fills options that weren't given from environment variables,
+        /// then from the `name = value` config file at path. Precedence is argv > environment > file > defaults.
+        /// The file stays mapped until the next parse, so string_view fields can point into it. Each call
+        /// starts from a default T, so calling it again reloads a changed file.
+        /// @param envp Environment block, or nullptr to skip environment variables.
+        [[nodiscard]] ParseResult parseWithConfig(char const* path, char const* const* envp = detail::environment()) noexcept {
+            static_assert(detail::config_files_v<T>, "Config files need 'static constexpr bool ConfigFiles = true'");
+
+            // nothing may point into the previous mapping, and keys it set must not count as given
+            clearResult();
+            size_t positionalCount = 0;
+            auto result = parseTokens(positionalCount);
+            if (!result.isOk()) {
+                return result;
+            }
+            result = applyEnvironment(envp);
+            if (!result.isOk()) {
+                return report(result, NoArgIndex);
+            }
+            result = applyConfigFile(path);
+            if (!result.isOk()) {
+                return report(result, NoArgIndex);
+            }
+            result = parseSubcommand(envp);
+            if (!result.isOk()) {
+                return result;
+            }
+            return report(checkRequired(positionalCount), NoArgIndex);
+        }
+
+        /// @brief Returns the help message, rendered at compile time (except for the program name).
+        [[nodiscard]] constexpr HelpText helpText(bool ansi = true) const noexcept {
+            if (ansi) {
+                return {s_helpPrefix<true>.view(), m_programName, s_helpBody<true>.view()};
+            }
+            return {s_helpPrefix<false>.view(), m_programName, s_helpBody<false>.view()};
+        }
+
+        /// @brief Prints the help message to stdout, ANSI-formatted unless `ansi` is false.
+        void printHelp(bool ansi = true) const noexcept {
+            printHelp(FileSink{stdout}, ansi);
+        }
+
+        /// @brief Writes the help message to the given sink, ANSI-formatted unless `ansi` is false.
+        template <OutputSink S>
+        constexpr void printHelp(S&& sink, bool ansi = true) const {
+            auto text = helpText(ansi);
+            detail::writeParts(sink, {text.prefix, text.programName, text.body});
+        }
+
+        /// @brief Writes the completion candidates for words, one per line, in a single write. words are
+        /// the words before the cursor (without the program name) followed by the one being completed,
+        /// as passed to `program --complete`.
+        template <OutputSink S>
+        static void writeCompletions(ArgSpan words, S&& sink) {
+            std::string out;
+            appendCompletions(words, out);
+            sink.write(out);
+        }
+
+        /// @brief Writes a script for shell that completes this program with `--complete`.
+        /// Needs `static constexpr bool Completion = true` in the struct to be answered by parse().
+        template <OutputSink S>
+        void writeCompletionScript(Shell shell, S&& sink) const {
+            std::string out;
+            detail::appendCompletionScript(shell, m_programName, out);
+            sink.write(out);
+        }
+
+    private:
+        /// @brief Answers `--complete <words...>` and `--completions <shell>` given as the first argument,
+        /// before anything else is parsed.
+        ParseResult answerCompletion() {
+            std::string_view first = m_args.size() > 1 ? m_args[1] : std::string_view{};
+            if (first == "--complete") {
+                writeCompletions(m_args.subspan(2), FileSink{stdout});
+                return ParseResult::failure(ParseError::CompletionWritten);
+            }
+            if (first == "--completions") {
+                auto shell = m_args.size() > 2 ? ValueParser<Shell>::parse(m_args[2]) : std::nullopt;
+                if (!shell) {
+                    return report(ParseResult::failure(ParseError::InvalidValue, first), 1);
+                }
+                writeCompletionScript(*shell, FileSink{stdout});
+                return ParseResult::failure(ParseError::CompletionWritten);
+            }
+            return ParseResult::success();
+        }
+
+        static void appendCompletions(ArgSpan words, std::string& out) {
+            std::string_view partial = words.empty() ? std::string_view{} : words.back();
+            size_t count = words.empty() ? 0 : words.size() - 1;
+
+            // find the subcommand and whether the partial word is an option's value
+            uint16_t valueOf = s_optionIndex.npos;
+            for (size_t i = 0; i < count; ++i) {
+                std::string_view word = words[i];
+                if (valueOf != s_optionIndex.npos) {
+                    // bash splits "--mode=fast" into "--mode" "=" "fast"
+                    if (word != "=") {
+                        valueOf = s_optionIndex.npos;
+                    }
+                    continue;
+                }
+                if (word == "--") {
+                    return;
+                }
+                if (word.size() > 1 && word.front() == '-') {
+                    auto slot = s_optionIndex.find(word);
+                    if (slot != s_optionIndex.npos && s_needsValue[slot]) {
+                        valueOf = slot;
+                    }
+                    continue;
+                }
+                if constexpr (hasSubcommands()) {
+                    appendSubcommandCompletions(word, words.subspan(i + 1), out);
+                    return;
+                }
+            }
+
+            auto append = [&](std::string_view prefix, std::string_view name) {
+                out += prefix;
+                out += name;
+                out += '\n';
+            };
+            if (valueOf != s_optionIndex.npos) {
+                for (std::string_view name : valueNames(valueOf)) {
+                    if (name.starts_with(partial)) append({}, name);
+                }
+            } else if (auto eq = partial.find('='); partial.starts_with('-') && eq != std::string_view::npos) {
+                auto slot = s_optionIndex.find(partial.substr(0, eq));
+                if (slot != s_optionIndex.npos) {
+                    for (std::string_view name : valueNames(slot)) {
+                        if (name.starts_with(partial.substr(eq + 1))) append(partial.substr(0, eq + 1), name);
+                    }
+                }
+            } else if (partial.starts_with('-')) {
+                std::span<std::string_view const> names = s_optionNames.names;
+                for (size_t i = detail::lowerBound(names, partial); i < names.size() && names[i].starts_with(partial); ++i) {
+                    append({}, names[i]);
+                }
+            } else {
+                for (std::string_view name : s_commandNames) {
+                    if (name.starts_with(partial)) append({}, name);
+                }
+            }
+        }
+
+        static void appendSubcommandCompletions(std::string_view name, ArgSpan words, std::string& out) {
+            if constexpr (hasSubcommands()) {
+                auto slot = s_subcommandIndex.find(name);
+                constexpr auto const& entry = std::get<subcommandsIndex()>(T::Options);
+                using Variant = std::remove_cvref_t<decltype(std::declval<T&>().*entry.field())>;
+                [&]<size_t... K>(std::index_sequence<K...>) {
+                    (void) ((slot == K && (ArgParser<std::variant_alternative_t<K + 1, Variant>, Observer>::appendCompletions(words, out), true)) || ...);
+                }(std::make_index_sequence<entry.count()>());
+            }
+        }
+
+        /// @brief Names an option's value can take: those of its enum type, otherwise none.
+        static constexpr std::span<std::string_view const> valueNames(size_t slot) noexcept {
+            std::span<std::string_view const> names;
+            [&]<size_t... I>(std::index_sequence<I...>) {
+                ([&] {
+                    if constexpr (detail::is_option_v<std::tuple_element_t<I, OptsT>>) {
+                        using ValueType = detail::field_value_t<typename std::tuple_element_t<I, OptsT>::Type>;
+                        if constexpr (detail::named_enum<ValueType>) {
+                            if (slot == I) names = detail::EnumNames<ValueType>::value;
+                        }
+                    }
+                }(), ...);
+            }(std::make_index_sequence<TupleSize>());
+            return names;
+        }
+
+        template <typename F>
+        static constexpr void forEachOption(F&& func) {
+            [&]<size_t... I>(std::index_sequence<I...>){
+                ([&] {
+                    if constexpr (detail::is_option_v<std::tuple_element_t<I, OptsT>>) {
+                        func(std::get<I>(T::Options));
+                    }
+                }(), ...);
+            }(std::make_index_sequence<TupleSize>());
+        }
+
+        template <typename F>
+        static constexpr void forEachArg(F&& func) {
+            [&]<size_t... I>(std::index_sequence<I...>){
+                ([&] {
+                    if constexpr (detail::is_arg_v<std::tuple_element_t<I, OptsT>>) {
+                        func(std::get<I>(T::Options));
+                    }
+                }(), ...);
+            }(std::make_index_sequence<TupleSize>());
+        }
+
+        template <bool Ansi>
+        struct HelpStyle {
+            static constexpr std::string_view Bold = Ansi ? "\x1b[1m" : "";
+            static constexpr std::string_view BoldLine = Ansi ? "\x1b[1m\x1b[4m" : "";
+            static constexpr std::string_view Reset = Ansi ? "\x1b[0m" : "";
+        };
+
+        template <bool Ansi>
+        static constexpr void renderHelpPrefix(detail::TextBuilder& out) noexcept {
+            using Style = HelpStyle<Ansi>;
+
+            if constexpr (requires { T::Description; }) {
+                out << T::Description << '\n';
+            }
+
+            out << Style::BoldLine << "Usage:" << Style::Reset << ' ';
+        }
+
+        template <bool Ansi>
+        static constexpr void renderHelpBody(detail::TextBuilder& out) noexcept {
+            using Style = HelpStyle<Ansi>;
+
+            if constexpr (optionCount() > 0) {
+                out << " [OPTIONS]";
+            }
+
+            forEachArg([&](auto const& arg) {
+                if constexpr (arg.isOptional()) {
+                    out << " [" << arg.name() << ']';
+                } else {
+                    out << " <" << arg.name() << '>';
+                }
+            });
+
+            if constexpr (hasVarArgs()) {
+                out << " [...]";
+            }
+
+            if constexpr (hasSubcommands()) {
+                out << " <COMMAND> [...]";
+            }
+
+            out << '\n';
+
+            if constexpr (hasSubcommands()) {
+                out << '\n' << Style::BoldLine << "Commands:" << Style::Reset << '\n';
+
+                std::apply([&](auto const&... command) {
+                    ([&] {
+                        out << "  " << Style::Bold << command.name() << Style::Reset;
+                        if (!command.description().empty()) {
+                            out << ": " << command.description();
+                        }
+                        out << '\n';
+                    }(), ...);
+                }, std::get<subcommandsIndex()>(T::Options).commands());
+            }
+
+            if constexpr (argumentCount() > 0 || hasVarArgs()) {
+                out << '\n' << Style::BoldLine << "Arguments:" << Style::Reset << '\n';
+
+                forEachArg([&](auto const& arg) {
+                    out << "  " << Style::Bold << arg.name() << Style::Reset << ": " << arg.description();
+                    detail::renderConstraints(out, arg.constraints());
+                    out << '\n';
+                });
+
+                if constexpr (hasVarArgs()) {
+                    out << "  " << Style::Bold << "[...]" << Style::Reset << ": "
+                        << std::get<varArgsIndex()>(T::Options).description() << '\n';
+                }
+            }
+
+            if constexpr (optionCount() > 0) {
+                out << '\n' << Style::BoldLine << "Options:" << Style::Reset << '\n';
+
+                forEachOption([&](auto const& opt) {
+                    out << "  " << Style::Bold;
+                    if (!opt.altName().empty()) {
+                        out << opt.altName() << ", ";
+                    }
+                    out << opt.name() << Style::Reset;
+
+                    if constexpr (opt.needsValue()) {
+                        using ValueType = detail::field_value_t<typename std::remove_cvref_t<decltype(opt)>::Type>;
+                        if constexpr (detail::named_enum<ValueType>) {
+                            char separator = '<';
+                            out << ' ';
+                            for (auto const& entry : EnumTraits<ValueType>::Names) {
+                                out << separator << entry.first;
+                                separator = '|';
+                            }
+                            out << '>';
+                        } else {
+                            out << " <value>";
+                        }
+                    }
+
+                    if constexpr (opt.isRepeatable()) {
+                        out << "...";
+                    }
+
+                    if (!opt.description().empty()) {
+                        out << ": " << opt.description();
+                    }
+                    if (!opt.envName().empty()) {
+                        out << " [env: " << opt.envName() << ']';
+                    }
+                    detail::renderConstraints(out, opt.constraints());
+                    if (opt.isRequired()) {
+                        out << " [required]";
+                    }
+                    out << '\n';
+                });
+            }
+        }
+
+        template <size_t N>
+        struct RenderedText {
+            std::array<char, N + 1> data{};
+
+            [[nodiscard]] constexpr std::string_view view() const noexcept { return {data.data(), N}; }
+        };
+
+        template <auto Render>
+        static consteval size_t renderedSize() noexcept {
+            detail::TextBuilder counter;
+            Render(counter);
+            return counter.size;
+        }
+
+        template <auto Render>
+        static consteval auto renderText() noexcept {
+            RenderedText<renderedSize<Render>()> text{};
+            detail::TextBuilder out{text.data.data()};
+            Render(out);
+            return text;
+        }
+
+        template <bool Ansi>
+        static constexpr auto s_helpPrefix = renderText<&ArgParser::renderHelpPrefix<Ansi>>();
+
+        template <bool Ansi>
+        static constexpr auto s_helpBody = renderText<&ArgParser::renderHelpBody<Ansi>>();
+
+        static consteval size_t optionNameCount() noexcept {
+            size_t count = 0;
+            forEachOption([&](auto const& opt) {
+                count += opt.altName().empty() ? 1 : 2;
+            });
+            return count;
+        }
+
+        static consteval auto buildOptionIndex() noexcept {
+            detail::NameIndex<optionNameCount()> index{};
+            [&]<size_t... I>(std::index_sequence<I...>) {
+                ([&] {
+                    if constexpr (detail::is_option_v<std::tuple_element_t<I, OptsT>>) {
+                        auto const& opt = std::get<I>(T::Options);
+                        index.insert(opt.name(), I);
+                        if (!opt.altName().empty()) {
+                            index.insert(opt.altName(), I);
+                        }
+                    }
+                }(), ...);
+            }(std::make_index_sequence<TupleSize>());
+            return index;
+        }
+
+        static consteval auto buildOptionNames() noexcept {
+            detail::SortedNames<optionNameCount()> sorted{};
+            size_t count = 0;
+            [&]<size_t... I>(std::index_sequence<I...>) {
+                ([&] {
+                    if constexpr (detail::is_option_v<std::tuple_element_t<I, OptsT>>) {
+                        auto const& opt = std::get<I>(T::Options);
+                        for (std::string_view name : {opt.name(), opt.altName()}) {
+                            if (!name.empty()) {
+                                sorted.names[count] = name;
+                                sorted.values[count++] = static_cast<uint16_t>(I);
+                            }
+                        }
+                    }
+                }(), ...);
+            }(std::make_index_sequence<TupleSize>());
+            sorted.sort();
+            return sorted;
+        }
+
+        using OptionHandler = ParseResult (ArgParser::*)(
+            std::string_view arg, std::string_view optName,
+            std::optional<std::string_view> inlineValue, detail::TokenCursor& tokens
+        );
+
+        template <size_t I>
+        static consteval OptionHandler optionHandler() noexcept {
+            if constexpr (detail::is_option_v<std::tuple_element_t<I, OptsT>>) {
+                return &ArgParser::parseOptionAt<I>;
+            } else {
+                return nullptr;
+            }
+        }
+
+        using ShortSlot = std::conditional_t<(TupleSize < 0xFF), uint8_t, uint16_t>;
+        static constexpr ShortSlot NoShortSlot = static_cast<ShortSlot>(~ShortSlot{});
+
+        static consteval auto buildShortIndex() noexcept {
+            std::array<ShortSlot, 256> table{};
+            table.fill(NoShortSlot);
+            [&]<size_t... I>(std::index_sequence<I...>) {
+                ([&] {
+                    if constexpr (detail::is_option_v<std::tuple_element_t<I, OptsT>>) {
+                        auto const& opt = std::get<I>(T::Options);
+                        for (std::string_view name : {opt.name(), opt.altName()}) {
+                            if (name.size() == 2 && name[0] == '-' && name[1] != '-') {
+                                table[static_cast<uint8_t>(name[1])] = static_cast<ShortSlot>(I);
+                            }
+                        }
+                    }
+                }(), ...);
+            }(std::make_index_sequence<TupleSize>());
+            return table;
+        }
+
+        static consteval auto buildNeedsValue() noexcept {
+            return []<size_t... I>(std::index_sequence<I...>) {
+                return std::array<bool, TupleSize>{[] {
+                    if constexpr (detail::is_option_v<std::tuple_element_t<I, OptsT>>) {
+                        return std::tuple_element_t<I, OptsT>::needsValue();
+                    } else {
+                        return false;
+                    }
+                }()...};
+            }(std::make_index_sequence<TupleSize>());
+        }
+
+        using PositionalHandler = ParseResult (ArgParser::*)(std::string_view value, size_t argIndex);
+
+        static constexpr size_t ArgCount = argumentCount();
+
+        struct ArgInfo {
+            std::string_view name;
+            bool optional;
+        };
+
+        /// @brief Tuple indices of the positional arguments, in declaration order.
+        static consteval auto argTupleIndices() noexcept {
+            std::array<size_t, ArgCount> indices{};
+            size_t count = 0;
+            [&]<size_t... I>(std::index_sequence<I...>) {
+                ((detail::is_arg_v<std::tuple_element_t<I, OptsT>> ? (indices[count++] = I) : 0), ...);
+            }(std::make_index_sequence<TupleSize>());
+            return indices;
+        }
+
+        static consteval auto buildArgInfo() noexcept {
+            std::array<ArgInfo, ArgCount> info{};
+            size_t idx = 0;
+            forEachArg([&](auto const& arg) {
+                info[idx++] = {arg.name(), arg.isOptional()};
+            });
+            return info;
+        }
+
+        static consteval size_t requiredArgCount() noexcept {
+            size_t count = 0;
+            size_t idx = 0;
+            forEachArg([&](auto const& arg) {
+                ++idx;
+                if (!arg.isOptional()) {
+                    count = idx;
+                }
+            });
+            return count;
+        }
+
+        static consteval auto buildPositionalHandlers() noexcept {
+            if constexpr (ArgCount == 0) {
+                return std::array<PositionalHandler, 0>{};
+            } else {
+                return []<size_t... I>(std::index_sequence<I...>) {
+                    constexpr auto indices = argTupleIndices();
+                    return std::array<PositionalHandler, ArgCount>{&ArgParser::parsePositionalAt<indices[I]>...};
+                }(std::make_index_sequence<ArgCount>());
+            }
+        }
+
+        static consteval auto buildOptionHandlers() noexcept {
+            return []<size_t... I>(std::index_sequence<I...>) {
+                return std::array<OptionHandler, TupleSize>{optionHandler<I>()...};
+            }(std::make_index_sequence<TupleSize>());
+        }
+
+        /// @brief Maps every option name to its tuple index.
+        static constexpr auto s_optionIndex = buildOptionIndex();
+
+        /// @brief All option names in sorted order, for abbreviations and suggestions.
+        static constexpr auto s_optionNames = buildOptionNames();
+        static constexpr std::span<std::string_view const> s_optionCandidates{s_optionNames.names};
+
+        /// @brief Maps the character of every single-char option (e.g. -v) to its tuple index.
+        static constexpr auto s_shortIndex = buildShortIndex();
+
+        /// @brief Whether the option at a tuple index takes a value.
+        static constexpr auto s_needsValue = buildNeedsValue();
+
+        static consteval size_t envNameCount() noexcept {
+            size_t count = 0;
+            forEachOption([&](auto const& opt) {
+                count += !opt.envName().empty();
+            });
+            return count;
+        }
+
+        static consteval auto buildEnvIndex() noexcept {
+            detail::NameIndex<envNameCount()> index{};
+            [&]<size_t... I>(std::index_sequence<I...>) {
+                ([&] {
+                    if constexpr (detail::is_option_v<std::tuple_element_t<I, OptsT>>) {
+                        auto const& opt = std::get<I>(T::Options);
+                        if (!opt.envName().empty()) {
+                            index.insert(opt.envName(), I);
+                        }
+                    }
+                }(), ...);
+            }(std::make_index_sequence<TupleSize>());
+            return index;
+        }
+
+        /// @brief Maps every environment variable name to its option's tuple index.
+        static constexpr auto s_envIndex = buildEnvIndex();
+
+        /// @brief Jump table of per-option setters, indexed by tuple index.
+        static const std::array<OptionHandler, TupleSize> s_optionHandlers;
+
+        /// @brief Jump table of positional setters, indexed by positional slot.
+        static const std::array<PositionalHandler, ArgCount> s_positionalHandlers;
+
+        /// @brief Names and optionality of the positional slots.
+        static constexpr auto s_argInfo = buildArgInfo();
+
+        /// @brief Number of leading positional slots that must be filled.
+        static constexpr size_t s_requiredArgCount = requiredArgCount();
+
+        static consteval size_t requiredOptionCount() noexcept {
+            size_t count = 0;
+            forEachOption([&](auto const& opt) {
+                if (opt.isRequired()) ++count;
+            });
+            return count;
+        }
+
+        static consteval auto buildRequiredOptions() noexcept {
+            detail::BitSet<TupleSize> mask{};
+            [&]<size_t... I>(std::index_sequence<I...>) {
+                ([&] {
+                    if constexpr (detail::is_option_v<std::tuple_element_t<I, OptsT>>) {
+                        if (std::get<I>(T::Options).isRequired()) mask.set(I);
+                    }
+                }(), ...);
+            }(std::make_index_sequence<TupleSize>());
+            return mask;
+        }
+
+        /// @brief Tuple indices of the required options, compared against m_seen after parsing.
+        static constexpr auto s_requiredOptions = buildRequiredOptions();
+
+        static constexpr bool Observed = !std::is_same_v<Observer, NoObserver>;
+        static constexpr size_t NoArgIndex = ParseResult::NoArgIndex;
+
+        /// @brief Maps an index into m_args to an index into the original argv.
+        constexpr size_t argvIndex(size_t argIndex) const noexcept {
+            return argIndex == NoArgIndex ? argIndex : argIndex + m_indexBase;
+        }
+
+        /// @brief Records where a failed result happened and passes it to the observer.
+        constexpr ParseResult report(ParseResult result, size_t argIndex) noexcept {
+            if (!result.isOk()) {
+                result.argIndex = argvIndex(argIndex);
+                if constexpr (Observed) {
+                    m_observer.onError(result.argIndex, result);
+                }
+            }
+            return result;
+        }
+
+        /// @brief Converts a value with ValueParser, timing it for the observer.
+        template <typename V>
+        constexpr std::optional<V> convert(std::string_view value, size_t argIndex) noexcept {
+            if constexpr (Observed) {
+                uint64_t start = detail::cycleCount();
+                auto parsed = ValueParser<V>::parse(value);
+                m_observer.onValue(argvIndex(argIndex), value, parsed.has_value(), detail::cycleCount() - start);
+                return parsed;
+            } else {
+                (void) argIndex;
+                return ValueParser<V>::parse(value);
+            }
+        }
+
+        constexpr void bind(ArgSpan args) noexcept {
+            m_args = args;
+            m_argc = static_cast<int>(args.size());
+            m_programName = {};
+            if (m_argc > 0) {
+                m_programName = args[0];
+                auto slash = m_programName.find_last_of('/');
+                if (slash != std::string_view::npos) {
+                    m_programName = m_programName.substr(slash + 1);
+                }
+            }
+        }
+
+        /// @brief Drops the result of an earlier parse, keeping the bound arguments.
+        constexpr void clearResult() noexcept {
+            m_options = T{};
+            m_seen = {};
+            m_subcommandIndex = 0;
+        }
+
+        constexpr void reset(ArgSpan args) noexcept {
+            clearResult();
+            if constexpr (detail::response_files_v<T>) {
+                m_responseFiles.reset();
+            }
+            if constexpr (detail::config_files_v<T>) {
+                m_configFile = detail::MappedFile{};
+            }
+            bind(args);
+        }
+
+        constexpr ParseResult expandResponseFiles() noexcept {
+            if constexpr (detail::response_files_v<T>) {
+                int failed = m_responseFiles.expanded() ? -1 : m_responseFiles.expand(m_args);
+                if (failed >= 0) {
+                    auto index = static_cast<size_t>(failed);
+                    return report(ParseResult::failure(ParseError::InvalidResponseFile, m_args[index]), index);
+                }
+                if (m_responseFiles.expanded()) {
+                    m_args = m_responseFiles.args();
+                    m_argc = static_cast<int>(m_args.size());
+                }
+            }
+            return ParseResult::success();
+        }
+
+        constexpr ParseResult parseTokens(size_t& positionalIndex) noexcept {
+            if constexpr (detail::completion_v<T>) {
+                if (!std::is_constant_evaluated() && m_indexBase == 0) {
+                    auto result = answerCompletion();
+                    if (!result.isOk()) {
+                        return result;
+                    }
+                }
+            }
+
+            auto expanded = expandResponseFiles();
+            if (!expanded.isOk()) {
+                return expanded;
+            }
+            if constexpr (detail::permute_v<T>) {
+                return parsePermuted(positionalIndex);
+            }
+
+            int varArgsStart = -1;
+
+            detail::TokenCursor tokens(m_args, 1);
+            while (auto const* token = tokens.next()) {
+                auto i = static_cast<int>(tokens.index());
+                if constexpr (Observed) {
+                    m_observer.onToken(argvIndex(tokens.index()), token->kind, token->text);
+                }
+
+                // vararg separator
+                if (token->kind == TokenKind::Separator) {
+                    if (i + 1 < m_argc) {
+                        varArgsStart = i + 1;
+                    }
+                    break;
+                }
+
+                // check option
+                if (token->kind != TokenKind::Positional) {
+                    auto result = tryParseOption(*token, tokens);
+                    if (!result.isOk()) {
+                        return report(result, tokens.index());
+                    }
+                } else if constexpr (hasSubcommands()) {
+                    // the rest belongs to the subcommand
+                    m_subcommandIndex = i;
+                    break;
+                } else {
+                    // positional argument
+                    auto result = tryParsePositional(token->text, positionalIndex, tokens.index());
+                    if (result.isOk()) {
+                        ++positionalIndex;
+                    } else if (result.error == ParseError::TooManyArgs) {
+                        if constexpr (hasVarArgs()) {
+                            varArgsStart = i;
+                            break;
+                        } else {
+                            return report(result, tokens.index());
+                        }
+                    } else {
+                        return report(result, tokens.index());
+                    }
+                }
+            }
+
+            if (varArgsStart >= 0) {
+                setVarArgs(varArgsStart);
+            }
+
+            return ParseResult::success();
+        }
+
+        /// @brief Permute mode: parses options through the whole argv up to "--", and moves the non-option
+        /// tokens behind them in their original order, so the VarArgs tail is still a contiguous span.
+        /// Options keep their order and their values, so the permuted argv parses the same way again.
+        constexpr ParseResult parsePermuted(size_t& positionalIndex) noexcept {
+            static_assert(!hasSubcommands(), "Permute mode doesn't support subcommands");
+
+            auto positional = [&](std::string_view text, size_t index) {
+                auto result = tryParsePositional(text, positionalIndex, index);
+                if (result.isOk()) {
+                    ++positionalIndex;
+                }
+                return result;
+            };
+
+            // tokens are only moved once the cursor is past them
+            detail::ArgPermuter permuter(m_args);
+            detail::TokenCursor tokens(m_args, 1);
+            while (auto const* token = tokens.next()) {
+                size_t index = tokens.index();
+                if constexpr (Observed) {
+                    m_observer.onToken(argvIndex(index), token->kind, token->text);
+                }
+
+                if (token->kind == TokenKind::Separator) {
+                    // "--" goes in front of the non-options, and everything after it is one
+                    for (size_t rest = index + 1; rest < m_args.size(); ++rest) {
+                        auto result = positional(m_args[rest], rest);
+                        if (result.error == ParseError::TooManyArgs) {
+                            break;
+                        }
+                        if (!result.isOk()) {
+                            return report(result, rest);
+                        }
+                    }
+                    permuter.add(index, index + 1, true);
+                    permuter.add(index + 1, m_args.size(), false);
+                    break;
+                }
+                if (token->kind != TokenKind::Positional) {
+                    auto result = tryParseOption(*token, tokens);
+                    if (!result.isOk()) {
+                        return report(result, tokens.index());
+                    }
+                    permuter.add(index, tokens.index() + 1, true);
+                    continue;
+                }
+
+                auto result = positional(token->text, index);
+                if (!result.isOk() && (result.error != ParseError::TooManyArgs || !hasVarArgs())) {
+                    return report(result, index);
+                }
+                permuter.add(index, index + 1, false);
+            }
+
+            size_t first = permuter.finish();
+            if (m_args.size() - first > positionalIndex) {
+                setVarArgs(static_cast<int>(first + positionalIndex));
+            }
+            return ParseResult::success();
+        }
+
+        constexpr ParseResult tryParseOption(detail::Token const& token, detail::TokenCursor& tokens) {
+            // handle --option=value syntax
+            std::string_view arg = token.text;
+            bool hasEq = token.eq != detail::Token::NoEq;
+            std::string_view optName = hasEq ? arg.substr(0, token.eq) : arg;
+            std::optional<std::string_view> inlineValue = hasEq ? std::optional{arg.substr(token.eq + 1)} : std::nullopt;
+
+            auto slot = s_optionIndex.find(optName, token.hash);
+            if (slot == s_optionIndex.npos) {
+                if (token.kind == TokenKind::Short && arg.size() > 2) {
+                    return tryParseShortCluster(arg, optName, tokens);
+                }
+                if constexpr (detail::abbreviations_v<T>) {
+                    if (token.kind == TokenKind::Long) {
+                        slot = findAbbreviation(optName);
+                    }
+                }
+                if (slot == detail::AmbiguousName) {
+                    auto result = ParseResult::failure(ParseError::AmbiguousOption, optName);
+                    result.candidates = &s_optionCandidates;
+                    return result;
+                }
+                if (slot == s_optionIndex.npos) {
+                    return unknownOption(optName);
+                }
+            }
+
+            return (this->*s_optionHandlers[slot])(arg, optName, inlineValue, tokens);
+        }
+
+        /// @brief Resolves a unique prefix of a long option name, e.g. --verb for --verbose.
+        static constexpr uint16_t findAbbreviation(std::string_view prefix) noexcept {
+            return detail::findPrefix(s_optionNames.names, s_optionNames.values, prefix);
+        }
+
+        static constexpr ParseResult unknownOption(std::string_view name) noexcept {
+            auto result = ParseResult::failure(ParseError::UnknownOption, name);
+            result.candidates = &s_optionCandidates;
+            return result;
+        }
+
+        /// @brief Parses clustered short options, e.g. -abc, -xvf file or -j8.
+        constexpr ParseResult tryParseShortCluster(std::string_view arg, std::string_view optName, detail::TokenCursor& tokens) {
+            for (size_t pos = 1; pos < arg.size(); ++pos) {
+                auto slot = s_shortIndex[static_cast<uint8_t>(arg[pos])];
+                if (slot == NoShortSlot) {
+                    return unknownOption(optName);
+                }
+
+                if (!s_needsValue[slot]) {
+                    auto result = (this->*s_optionHandlers[slot])(arg, arg, std::nullopt, tokens);
+                    if (!result.isOk()) {
+                        return result;
+                    }
+                    continue;
+                }
+
+                // the rest of the cluster is the value, otherwise it's the next token
+                auto rest = arg.substr(pos + 1);
+                if (rest.starts_with('=')) {
+                    rest.remove_prefix(1);
+                }
+                auto inlineValue = pos + 1 == arg.size() ? std::nullopt : std::optional{rest};
+                return (this->*s_optionHandlers[slot])(arg, arg, inlineValue, tokens);
+            }
+
+            return ParseResult::success();
+        }
+
+        static consteval auto buildSubcommandIndex() noexcept {
+            if constexpr (hasSubcommands()) {
+                constexpr auto const& commands = std::get<subcommandsIndex()>(T::Options).commands();
+                detail::NameIndex<std::tuple_size_v<std::remove_cvref_t<decltype(commands)>>> index{};
+                [&]<size_t... K>(std::index_sequence<K...>) {
+                    (index.insert(std::get<K>(commands).name(), K), ...);
+                }(std::make_index_sequence<std::tuple_size_v<std::remove_cvref_t<decltype(commands)>>>());
+                return index;
+            } else {
+                return detail::NameIndex<0>{};
+            }
+        }
+
+        /// @brief Maps every subcommand name to its position in Subcommands.
+        static constexpr auto s_subcommandIndex = buildSubcommandIndex();
+
+        static consteval auto buildCommandNames() noexcept {
+            if constexpr (hasSubcommands()) {
+                constexpr auto const& commands = std::get<subcommandsIndex()>(T::Options).commands();
+                return std::apply([](auto const&... command) {
+                    return std::array<std::string_view, sizeof...(command)>{command.name()...};
+                }, commands);
+            } else {
+                return std::array<std::string_view, 0>{};
+            }
+        }
+
+        /// @brief All subcommand names, offered as suggestions for unknown commands.
+        static constexpr auto s_commandNames = buildCommandNames();
+        static constexpr std::span<std::string_view const> s_commandCandidates{s_commandNames};
+
+        /// @brief Parses the arguments after the subcommand name into the selected struct.
+        constexpr ParseResult parseSubcommand(char const* const* envp) noexcept {
+            if constexpr (hasSubcommands()) {
+                static_assert(argumentCount() == 0 && !hasVarArgs(),
+                    "Subcommands can't be combined with positional arguments");
+
+                if (m_subcommandIndex <= 0) {
+                    return ParseResult::success();
+                }
+
+                std::string_view name = m_args[static_cast<size_t>(m_subcommandIndex)];
+                auto slot = s_subcommandIndex.find(name);
+                if (slot == s_subcommandIndex.npos) {
+                    auto result = ParseResult::failure(ParseError::UnknownCommand, name);
+                    result.candidates = &s_commandCandidates;
+                    return report(result, static_cast<size_t>(m_subcommandIndex));
+                }
+
+                constexpr auto const& entry = std::get<subcommandsIndex()>(T::Options);
+                ParseResult result = ParseResult::success();
+                [&]<size_t... K>(std::index_sequence<K...>) {
+                    (void) ((slot == K && (result = parseSubcommandAt<K>(entry.field(), envp), true)) || ...);
+                }(std::make_index_sequence<entry.count()>());
+                return result;
+            } else {
+                (void) envp;
+                return ParseResult::success();
+            }
+        }
+
+        template <size_t K, typename F>
+        constexpr ParseResult parseSubcommandAt(F field, char const* const* envp) noexcept {
+            using Variant = std::remove_cvref_t<decltype(m_options.*field)>;
+            using Sub = std::variant_alternative_t<K + 1, Variant>;
+            static_assert(!detail::response_files_v<Sub>, "Response files are expanded by the top-level struct");
+
+            ArgParser<Sub, Observer> parser(m_args.subspan(static_cast<size_t>(m_subcommandIndex)));
+            if constexpr (Observed) {
+                parser.observer() = std::move(m_observer);
+            }
+            parser.m_indexBase = m_indexBase + static_cast<size_t>(m_subcommandIndex);
+
+            ParseResult result = ParseResult::success();
+            if (envp) {
+                result = parser.parseWithEnv(envp);
+            } else {
+                result = parser.parse();
+            }
+
+            if constexpr (Observed) {
+                m_observer = std::move(parser.observer());
+            }
+
+            if (result.isOk()) {
+                (m_options.*field).template emplace<K + 1>(std::move(parser.result()));
+            }
+            return result;
+        }
+
+        /// @brief Single pass over the environment, applying variables of options that weren't set yet.
+        constexpr ParseResult applyEnvironment(char const* const* envp) noexcept {
+            if constexpr (envNameCount() > 0) {
+                if (!envp) {
+                    return ParseResult::success();
+                }
+
+                for (; *envp; ++envp) {
+                    std::string_view entry = *envp;
+                    auto eqPos = entry.find('=');
+                    if (eqPos == std::string_view::npos) {
+                        continue;
+                    }
+
+                    auto slot = s_envIndex.find(entry.substr(0, eqPos));
+                    if (slot == s_envIndex.npos || m_seen.test(slot)) {
+                        continue;
+                    }
+
+                    detail::TokenCursor none({}, 0); // index() is NoArgIndex before the first next()
+                    auto result = (this->*s_optionHandlers[slot])(entry, entry.substr(0, eqPos), entry.substr(eqPos + 1), none);
+                    if (!result.isOk()) {
+                        return result;
+                    }
+                }
+            }
+            return ParseResult::success();
+        }
+
+        /// @brief Applies every `name = value` line of the file to the options argv and environment didn't set.
+        /// Names are option names without their dashes, lines starting with '#' are comments, a value
+        /// may be wrapped in double quotes, and a name alone sets a flag.
+        ParseResult applyConfigFile(char const* path) noexcept {
+            if constexpr (detail::config_files_v<T>) {
+                if (!m_configFile.open(path)) {
+                    return ParseResult::failure(ParseError::InvalidConfigFile, path);
+                }
+
+                auto given = m_seen;
+                std::string_view text{m_configFile.data(), m_configFile.size()};
+                detail::TokenCursor none({}, 0); // index() is NoArgIndex before the first next()
+                while (!text.empty()) {
+                    auto end = text.find('\n');
+                    auto line = detail::trimSpaces(text.substr(0, end));
+                    text.remove_prefix(end == std::string_view::npos ? text.size() : end + 1);
+                    if (line.empty() || line.front() == '#') {
+                        continue;
+                    }
+
+                    auto eq = line.find('=');
+                    auto name = detail::trimSpaces(line.substr(0, eq));
+                    std::optional<std::string_view> value;
+                    if (eq != std::string_view::npos) {
+                        auto raw = detail::trimSpaces(line.substr(eq + 1));
+                        if (raw.size() >= 2 && raw.front() == '"' && raw.back() == '"') {
+                            raw = raw.substr(1, raw.size() - 2);
+                        }
+                        value = raw;
+                    }
+
+                    auto slot = s_optionIndex.find(name.size() == 1 ? "-" : "--", name);
+                    if (slot == s_optionIndex.npos) {
+                        return unknownOption(name);
+                    }
+                    if (given.test(slot)) {
+                        continue;
+                    }
+                    auto result = (this->*s_optionHandlers[slot])(line, name, value, none);
+                    if (!result.isOk()) {
+                        return result;
+                    }
+                }
+            }
+            (void) path;
+            return ParseResult::success();
+        }
+
+        template <size_t I>
+        constexpr ParseResult parseOptionAt(
+            std::string_view arg, std::string_view optName,
+            std::optional<std::string_view> inlineValue, detail::TokenCursor& tokens
+        ) {
+            constexpr auto const& opt = std::get<I>(T::Options);
+            using FieldType = std::remove_cvref_t<decltype(opt)>::Type;
+            using InnerType = detail::unwrap_optional_t<FieldType>;
+
+            if constexpr (Observed) {
+                m_observer.onOption(argvIndex(tokens.index()), I, opt.name());
+            }
+
+            if constexpr (std::is_same_v<InnerType, bool>) {
+                if (inlineValue) {
+                    auto parsed = convert<bool>(*inlineValue, tokens.index());
+                    if (!parsed) {
+                        return ParseResult::failure(ParseError::InvalidValue, arg);
+                    }
+                    m_options.*opt.field() = *parsed;
+                } else {
+                    m_options.*opt.field() = true;
+                }
+            } else {
+                std::string_view value;
+                if (inlineValue) {
+                    value = *inlineValue;
+                } else if (auto const* next = tokens.next()) {
+                    value = next->text;
+                } else {
+                    return ParseResult::failure(ParseError::MissingValue, optName);
+                }
+
+                using ValueType = detail::field_value_t<FieldType>;
+                auto parsed = convert<ValueType>(value, tokens.index());
+                if (!parsed) {
+                    return ParseResult::failure(ParseError::InvalidValue, arg);
+                }
+                if constexpr (opt.constraints().any()) {
+                    if (!opt.constraints().accepts(*parsed)) {
+                        return ParseResult::violation(detail::ConstraintError<T, I>::view(), value);
+                    }
+                }
+
+                if constexpr (detail::is_collect_v<FieldType>) {
+                    if (!(m_options.*opt.field()).push(*parsed)) {
+                        return ParseResult::failure(ParseError::TooManyValues, optName);
+                    }
+                } else if constexpr (detail::is_collect_views_v<FieldType>) {
+                    if (!(m_options.*opt.field()).push(value)) {
+                        return ParseResult::failure(ParseError::TooManyValues, optName);
+                    }
+                } else {
+                    m_options.*opt.field() = *parsed;
+                }
+            }
+
+            m_seen.set(I);
+            return ParseResult::success();
+        }
+
+        constexpr ParseResult tryParsePositional(std::string_view value, size_t targetIndex, size_t argIndex) noexcept {
+            if (targetIndex >= ArgCount) {
+                return ParseResult::failure(ParseError::TooManyArgs, value);
+            }
+            return (this->*s_positionalHandlers[targetIndex])(value, argIndex);
+        }
+
+        template <size_t I>
+        constexpr ParseResult parsePositionalAt(std::string_view value, size_t argIndex) noexcept {
+            constexpr auto const& arg = std::get<I>(T::Options);
+            using FieldType = std::remove_cvref_t<decltype(arg)>::Type;
+            using InnerType = detail::unwrap_optional_t<FieldType>;
+
+            auto parsed = convert<InnerType>(value, argIndex);
+            if (!parsed) {
+                return ParseResult::failure(ParseError::InvalidValue, value);
+            }
+            if constexpr (arg.constraints().any()) {
+                if (!arg.constraints().accepts(*parsed)) {
+                    return ParseResult::violation(detail::ConstraintError<T, I>::view(), value);
+                }
+            }
+
+            m_options.*arg.field() = *parsed;
+            m_seen.set(I);
+            return ParseResult::success();
+        }
+
+        constexpr void setVarArgs(int startIndex) noexcept {
+            if constexpr (hasVarArgs()) {
+                constexpr auto const& varArgs = std::get<varArgsIndex()>(T::Options);
+                using FieldType = std::remove_cvref_t<decltype(varArgs)>::Type;
+                auto start = static_cast<size_t>(startIndex);
+                m_options.*varArgs.field() = detail::makeVarArgs<FieldType>(m_args.subspan(start), argvIndex(start));
+                if (start < m_args.size()) {
+                    m_seen.set(varArgsIndex());
+                }
+            }
+        }
+
+        [[nodiscard]] constexpr ParseResult checkRequired(size_t count) const noexcept {
+            if constexpr (requiredOptionCount() > 0) {
+                if (!s_requiredOptions.subsetOf(m_seen)) {
+                    return missingRequiredOption(s_requiredOptions.firstMissingFrom(m_seen));
+                }
+            }
+            if (count >= s_requiredArgCount) {
+                return ParseResult::success();
+            }
+            return missingRequired(count);
+        }
+
+        [[nodiscard]] static constexpr ParseResult missingRequiredOption(size_t index) noexcept {
+            std::string_view name;
+            [&]<size_t... I>(std::index_sequence<I...>) {
+                ([&] {
+                    if constexpr (detail::is_option_v<std::tuple_element_t<I, OptsT>>) {
+                        if (I == index) name = std::get<I>(T::Options).name();
+                    }
+                }(), ...);
+            }(std::make_index_sequence<TupleSize>());
+            return ParseResult::failure(ParseError::MissingRequiredOption, name);
+        }
+
+        [[nodiscard]] static constexpr ParseResult missingRequired(size_t count) noexcept {
+            for (size_t idx = count; idx < ArgCount; ++idx) {
+                if (!s_argInfo[idx].optional) {
+                    return ParseResult::failure(ParseError::MissingRequiredArg, s_argInfo[idx].name);
+                }
+            }
+            return ParseResult::success();
+        }
+
+    private:
+        T m_options{};
+        detail::BitSet<TupleSize> m_seen{}; ///< entries the last parse stored into, by tuple index
+        int m_subcommandIndex = 0;
+        int m_argc{};
+        ArgSpan m_args{};
+        std::string_view m_programName{};
+
+        [[no_unique_address]] std::conditional_t<detail::response_files_v<T>, detail::ResponseFiles, detail::Empty> m_responseFiles{};
+        [[no_unique_address]] std::conditional_t<detail::config_files_v<T>, detail::MappedFile, detail::Empty> m_configFile{};
+        [[no_unique_address]] Observer m_observer{};
+        size_t m_indexBase = 0; ///< position of m_args[0] in argv, non-zero for subcommands
+
+        template <class, class>
+        friend class ArgParser;
+    };
+
+    template <class T, class Observer>
+    constexpr std::array<typename ArgParser<T, Observer>::OptionHandler, ArgParser<T, Observer>::TupleSize>
+        ArgParser<T, Observer>::s_optionHandlers = ArgParser<T, Observer>::buildOptionHandlers();
+
+    template <class T, class Observer>
+    constexpr std::array<typename ArgParser<T, Observer>::PositionalHandler, ArgParser<T, Observer>::ArgCount>
+        ArgParser<T, Observer>::s_positionalHandlers = ArgParser<T, Observer>::buildPositionalHandlers();
+
+    namespace detail {
+        // Not constexpr, so reaching one fails compilation of parseStatic with the error as its name.
+        inline void static_args_missing_value(std::string_view) noexcept {}
+        inline void static_args_invalid_value(std::string_view) noexcept {}
+        inline void static_args_unknown_option(std::string_view) noexcept {}
+        inline void static_args_missing_required_arg(std::string_view) noexcept {}
+        inline void static_args_too_many_args(std::string_view) noexcept {}
+        inline void static_args_too_many_values(std::string_view) noexcept {}
+        inline void static_args_unknown_command(std::string_view) noexcept {}
+        inline void static_args_missing_required_option(std::string_view) noexcept {}
+        inline void static_args_ambiguous_option(std::string_view) noexcept {}
+        inline void static_args_rejected(std::string_view) noexcept {}
+
+        constexpr void rejectStaticArgs(ParseResult const& result) noexcept {
+            switch (result.error) {
+                case ParseError::None: return;
+                case ParseError::MissingValue: return static_args_missing_value(result.context);
+                case ParseError::InvalidValue: return static_args_invalid_value(result.context);
+                case ParseError::UnknownOption: return static_args_unknown_option(result.context);
+                case ParseError::MissingRequiredArg: return static_args_missing_required_arg(result.context);
+                case ParseError::TooManyArgs: return static_args_too_many_args(result.context);
+                case ParseError::TooManyValues: return static_args_too_many_values(result.context);
+                case ParseError::UnknownCommand: return static_args_unknown_command(result.context);
+                case ParseError::MissingRequiredOption: return static_args_missing_required_option(result.context);
+                case ParseError::AmbiguousOption: return static_args_ambiguous_option(result.context);
+                default: return static_args_rejected(result.context);
+            }
+        }
 
-        template <typename S>
-        struct is_varargs<VarArgs<S>> : std::true_type {};
+        template <class T>
+        consteval T parseStaticArgs(ArgSpan argv) noexcept {
+            static_assert(!response_files_v<T>, "Response files can't be read at compile time");
+            static_assert(!config_files_v<T>, "Config files can't be read at compile time");
+            static_assert(!ArgParser<T>::hasVarArgs(), "VarArgs would point into the compile-time argv");
 
-        template <typename T>
-        constexpr bool is_varargs_v = is_varargs<std::remove_cvref_t<T>>::value;
+            ArgParser<T> parser;
+            rejectStaticArgs(parser.parse(argv));
+            return parser.result();
+        }
     } // namespace detail
 
-    /// @brief Command-line argument parser for a given options struct T.
+    /// @brief Parses a command line fixed at compile time, e.g. the defaults of an appliance build:
+    /// `constinit auto defaults = slic::parseStatic<Config>({"--threads", "8"});`
+    /// Arguments are given without the program name. An invalid command line doesn't compile,
+    /// failing with a call to `static_args_<error>(context)`. Structs with ResponseFiles, ConfigFiles
+    /// or VarArgs are rejected: files can't be read, nor argv outlive, the compile-time parse.
+    template <class T, size_t N>
+    consteval T parseStatic(std::string_view const (&args)[N]) noexcept {
+        std::array<std::string_view, N + 1> argv{};
+        for (size_t i = 0; i < N; ++i) {
+            argv[i + 1] = args[i];
+        }
+        return detail::parseStaticArgs<T>(std::span<std::string_view const>{argv});
+    }
+
+    /// @brief parseStatic without arguments: the defaults, checked against the required entries.
     template <class T>
-    class ArgParser {
-    private:
-        using OptsT = decltype(T::Options);
-        static constexpr size_t TupleSize = std::tuple_size_v<OptsT>;
+    consteval T parseStatic() noexcept {
+        std::array<std::string_view, 1> argv{};
+        return detail::parseStaticArgs<T>(std::span<std::string_view const>{argv});
+    }
 
-    public:
-        constexpr ArgParser(int argc, char const* const* argv) noexcept : m_argc(argc), m_argv(argv) {
-            if (argc > 0) {
-                m_programName = argv[0];
-                auto slash = m_programName.find_last_of('/');
-                if (slash != std::string_view::npos) {
-                    m_programName = m_programName.substr(slash + 1);
+    namespace detail {
+        /// @brief Writes a value into a field of the object. Flags get a value without data unless given with '='.
+        /// A value that breaks the constraints of the field points context at their description.
+        using FieldStore = ParseError (*)(void* object, std::string_view value, std::string_view& context);
+
+        /// @brief An option or positional argument in a CompactTable.
+        struct FieldDescriptor {
+            std::string_view name;
+            std::string_view altName;
+            bool needsValue;
+            bool required; ///< required option, or positional that isn't std::optional
+            FieldStore store;
+        };
+
+        /// @brief Options struct lowered to plain data, so one parse loop serves every struct.
+        struct CompactTable {
+            std::span<FieldDescriptor const> options;
+            std::span<FieldDescriptor const> args;
+            std::span<NameSlot const> index;              ///< every option name to its position in options
+            std::span<uint16_t const> required;           ///< positions of the required options
+            std::span<std::string_view const> const* names; ///< every option name in sorted order
+            std::span<uint16_t const> nameOptions;        ///< position in options of each of names
+            void (*varArgs)(void* object, ArgSpan rest, size_t argIndex);  ///< nullptr without VarArgs
+            bool abbreviations;                           ///< accept unique prefixes of long names
+        };
+
+        template <class T, size_t I>
+        ParseError storeField(void* object, std::string_view value, std::string_view& context) noexcept {
+            constexpr auto const& entry = std::get<I>(T::Options);
+            using FieldType = std::remove_cvref_t<decltype(entry)>::Type;
+            auto& field = static_cast<T*>(object)->*entry.field();
+
+            if constexpr (std::is_same_v<unwrap_optional_t<FieldType>, bool> && is_option_v<decltype(entry)>) {
+                if (value.data() == nullptr) {
+                    field = true;
+                    return ParseError::None;
                 }
             }
-        }
 
-        static consteval size_t optionCount() noexcept {
-            size_t count = 0;
-            [&]<size_t... I>(std::index_sequence<I...>) {
-                ((detail::is_option_v<std::tuple_element_t<I, OptsT>> ? ++count : 0), ...);
-            }(std::make_index_sequence<TupleSize>());
-            return count;
+            auto parsed = ValueParser<field_value_t<FieldType>>::parse(value);
+            if (!parsed) {
+                return ParseError::InvalidValue;
+            }
+            if constexpr (entry.constraints().any()) {
+                if (!entry.constraints().accepts(*parsed)) {
+                    context = ConstraintError<T, I>::view();
+                    return ParseError::InvalidValue;
+                }
+            }
+            if constexpr (is_collect_v<FieldType>) {
+                return field.push(*parsed) ? ParseError::None : ParseError::TooManyValues;
+            } else if constexpr (is_collect_views_v<FieldType>) {
+                return field.push(value) ? ParseError::None : ParseError::TooManyValues;
+            } else {
+                field = *parsed;
+                return ParseError::None;
+            }
         }
 
-        static consteval size_t argumentCount() noexcept {
-            size_t count = 0;
-            [&]<size_t... I>(std::index_sequence<I...>) {
-                ((detail::is_arg_v<std::tuple_element_t<I, OptsT>> ? ++count : 0), ...);
-            }(std::make_index_sequence<TupleSize>());
-            return count;
+        template <class T, size_t I>
+        void storeVarArgs(void* object, ArgSpan rest, size_t argIndex) noexcept {
+            constexpr auto const& varArgs = std::get<I>(T::Options);
+            using FieldType = std::remove_cvref_t<decltype(varArgs)>::Type;
+            static_cast<T*>(object)->*varArgs.field() = makeVarArgs<FieldType>(rest, argIndex);
         }
 
-        static consteval bool hasVarArgs() noexcept {
-            bool found = false;
-            [&]<size_t... I>(std::index_sequence<I...>) {
-                ((detail::is_varargs_v<std::tuple_element_t<I, OptsT>> ? (found = true) : false), ...);
-            }(std::make_index_sequence<TupleSize>());
-            return found;
-        }
+        /// @brief Builds the CompactTable of T. Only instantiated by CompactArgParser.
+        template <class T>
+        struct CompactLayout {
+            using OptsT = std::remove_cvref_t<decltype(T::Options)>;
+            static constexpr size_t TupleSize = std::tuple_size_v<OptsT>;
 
-        static consteval size_t varArgsIndex() noexcept {
-            static_assert(hasVarArgs(), "Index is only accessible if varargs exist");
-            size_t count = 0;
-            [&]<size_t... I>(std::index_sequence<I...>) {
-                ((detail::is_varargs_v<std::tuple_element_t<I, OptsT>> ? (count = I) : false), ...);
-            }(std::make_index_sequence<TupleSize>());
-            return count;
-        }
+            template <template <class> class Trait>
+            static consteval size_t count() noexcept {
+                return []<size_t... I>(std::index_sequence<I...>) {
+                    return (size_t{0} + ... + (Trait<std::tuple_element_t<I, OptsT>>::value ? 1 : 0));
+                }(std::make_index_sequence<TupleSize>());
+            }
 
-        [[nodiscard]] constexpr T const& result() const noexcept { return m_options; }
-        [[nodiscard]] constexpr T& result() noexcept { return m_options; }
-        [[nodiscard]] constexpr std::string_view programName() const noexcept { return m_programName; }
+            template <class E> struct IsOption : std::bool_constant<is_option_v<E>> {};
+            template <class E> struct IsArg : std::bool_constant<is_arg_v<E>> {};
+            template <class E> struct IsVarArgs : std::bool_constant<is_varargs_v<E>> {};
+            template <class E> struct IsUnsupported : std::bool_constant<is_subcommands_v<E>> {};
 
-        [[nodiscard]] constexpr ParseResult parse() noexcept {
-            size_t positionalIndex = 0;
-            int varArgsStart = -1;
+            static constexpr size_t OptionCount = count<IsOption>();
+            static constexpr size_t ArgCount = count<IsArg>();
 
-            for (int i = 1; i < m_argc; ++i) {
-                std::string_view arg = m_argv[i];
+            static_assert(count<IsVarArgs>() <= 1, "Only one VarArgs is allowed");
+            static_assert(count<IsUnsupported>() == 0, "CompactArgParser doesn't support subcommands");
+            static_assert(!response_files_v<T>, "CompactArgParser doesn't support response files");
+            static_assert(!permute_v<T>, "CompactArgParser doesn't support permute mode");
 
-                // vararg separator
-                if (arg == "--") {
-                    if (i + 1 < m_argc) {
-                        varArgsStart = i + 1;
-                    }
-                    break;
+            static consteval auto buildFields(bool positional) noexcept {
+                std::array<FieldDescriptor, (OptionCount > ArgCount ? OptionCount : ArgCount)> fields{};
+                size_t count = 0;
+                [&]<size_t... I>(std::index_sequence<I...>) {
+                    ([&] {
+                        using E = std::tuple_element_t<I, OptsT>;
+                        constexpr auto const& entry = std::get<I>(T::Options);
+                        if constexpr (is_option_v<E>) {
+                            if (!positional) {
+                                if (!entry.envName().empty()) {
+                                    compact_parser_has_no_environment();
+                                }
+                                fields[count++] = {entry.name(), entry.altName(), E::needsValue(), entry.isRequired(), &storeField<T, I>};
+                            }
+                        } else if constexpr (is_arg_v<E>) {
+                            if (positional) {
+                                fields[count++] = {entry.name(), {}, true, !E::isOptional(), &storeField<T, I>};
+                            }
+                        }
+                    }(), ...);
+                }(std::make_index_sequence<TupleSize>());
+                return fields;
+            }
+
+            static constexpr auto Options = buildFields(false);
+            static constexpr auto Args = buildFields(true);
+
+            static consteval size_t nameCount() noexcept {
+                size_t count = 0;
+                for (size_t i = 0; i < OptionCount; ++i) {
+                    count += Options[i].altName.empty() ? 1 : 2;
                 }
+                return count;
+            }
 
-                // check option
-                if (arg.starts_with('-')) {
-                    auto result = tryParseOption(arg, i);
-                    if (!result.isOk()) {
-                        return result;
+            static consteval auto buildIndex() noexcept {
+                NameIndex<nameCount()> index{};
+                for (size_t i = 0; i < OptionCount; ++i) {
+                    index.insert(Options[i].name, static_cast<uint16_t>(i));
+                    if (!Options[i].altName.empty()) {
+                        index.insert(Options[i].altName, static_cast<uint16_t>(i));
                     }
-                } else {
-                    // positional argument
-                    auto result = tryParsePositional(arg, positionalIndex);
-                    if (result.isOk()) {
-                        ++positionalIndex;
-                    } else if (result.error == ParseError::TooManyArgs) {
-                        if constexpr (hasVarArgs()) {
-                            varArgsStart = i;
-                            break;
-                        } else {
-                            return result;
+                }
+                return index;
+            }
+
+            static consteval auto buildNames() noexcept {
+                SortedNames<nameCount()> sorted{};
+                size_t count = 0;
+                for (size_t i = 0; i < OptionCount; ++i) {
+                    for (std::string_view name : {Options[i].name, Options[i].altName}) {
+                        if (!name.empty()) {
+                            sorted.names[count] = name;
+                            sorted.values[count++] = static_cast<uint16_t>(i);
                         }
-                    } else {
-                        return result;
                     }
                 }
+                sorted.sort();
+                return sorted;
             }
 
-            if (varArgsStart >= 0) {
-                setVarArgs(varArgsStart);
+            static consteval size_t requiredCount() noexcept {
+                size_t count = 0;
+                for (size_t i = 0; i < OptionCount; ++i) {
+                    count += Options[i].required ? 1 : 0;
+                }
+                return count;
             }
 
-            return checkRequired(positionalIndex);
-        }
-
-        /// @brief Prints an ANSI-formatted help message to stdout.
-        void printHelp() const noexcept {
-            #define ANSI_BOLD "\x1b[1m"
-            #define ANSI_UNDERLINE "\x1b[4m"
-            #define ANSI_RESET "\x1b[0m"
-            #define ANSI_BOLDLINE ANSI_BOLD ANSI_UNDERLINE
+            static consteval auto buildRequired() noexcept {
+                std::array<uint16_t, requiredCount()> required{};
+                size_t count = 0;
+                for (size_t i = 0; i < OptionCount; ++i) {
+                    if (Options[i].required) {
+                        required[count++] = static_cast<uint16_t>(i);
+                    }
+                }
+                return required;
+            }
 
-            if constexpr (requires { T::Description; }) {
-                std::cout << T::Description << '\n';
+            static consteval auto varArgs() noexcept {
+                return []<size_t... I>(std::index_sequence<I...>) {
+                    void (*store)(void*, ArgSpan, size_t) = nullptr;
+                    ([&] {
+                        if constexpr (is_varargs_v<std::tuple_element_t<I, OptsT>>) {
+                            store = &storeVarArgs<T, I>;
+                        }
+                    }(), ...);
+                    return store;
+                }(std::make_index_sequence<TupleSize>());
             }
 
-            std::cout << ANSI_BOLDLINE "Usage:" ANSI_RESET " " << m_programName;
+            static constexpr auto Index = buildIndex();
+            static constexpr auto Names = buildNames();
+            static constexpr auto Required = buildRequired();
+            static constexpr std::span<std::string_view const> NameList{Names.names};
 
-            if constexpr (optionCount() > 0) {
-                std::cout << " [OPTIONS]";
-            }
+            static constexpr CompactTable Table{
+                std::span<FieldDescriptor const>(Options.data(), OptionCount),
+                std::span<FieldDescriptor const>(Args.data(), ArgCount),
+                Index.slots(),
+                Required,
+                &NameList,
+                Names.values,
+                varArgs(),
+                abbreviations_v<T>
+            };
+        };
 
-            forEachArg([](auto const& arg) {
-                if constexpr (arg.isOptional()) {
-                    std::cout << " [" << arg.name() << ']';
-                } else {
-                    std::cout << " <" << arg.name() << '>';
-                }
-            });
+        /// @brief The parse loop shared by all CompactArgParser instantiations.
+        /// seen must have a bit for every option of the table, all cleared.
+        inline ParseResult compactParse(CompactTable const& table, void* object, ArgSpan args, std::span<uint64_t> seen) noexcept {
+            auto fail = [](ParseError error, std::string_view context, size_t index) {
+                auto result = ParseResult::failure(error, context);
+                result.argIndex = index;
+                return result;
+            };
 
-            if constexpr (hasVarArgs()) {
-                std::cout << " [...]";
-            }
+            // stores a value into the option at slot; errors mention arg if the value is bad, name otherwise
+            auto apply = [&](size_t slot, std::string_view value, std::string_view arg, std::string_view name, size_t index) {
+                std::string_view context = arg;
+                ParseError error = table.options[slot].store(object, value, context);
+                if (error != ParseError::None) {
+                    auto failed = fail(error, error == ParseError::InvalidValue ? context : name, index);
+                    if (context.data() != arg.data()) failed.value = value; // broke a constraint
+                    return failed;
+                }
+                seen[slot / 64] |= uint64_t{1} << (slot % 64);
+                return ParseResult::success();
+            };
 
-            std::cout << '\n';
+            auto takeValue = [&](TokenCursor& tokens, std::string_view& value) {
+                if (auto const* next = tokens.next()) {
+                    value = next->text;
+                    return true;
+                }
+                return false;
+            };
 
-            if constexpr (argumentCount() > 0 || hasVarArgs()) {
-                std::cout << "\n" ANSI_BOLDLINE "Arguments:" ANSI_RESET "\n";
+            size_t positional = 0;
+            TokenCursor tokens(args, 1);
+            while (auto const* token = tokens.next()) {
+                size_t index = tokens.index();
+                std::string_view arg = token->text;
 
-                forEachArg([](auto const& arg) {
-                    std::cout << "  " ANSI_BOLD << arg.name() << ANSI_RESET ": " << arg.description() << '\n';
-                });
+                if (token->kind == TokenKind::Separator) {
+                    if (table.varArgs && index + 1 < args.size()) {
+                        table.varArgs(object, args.subspan(index + 1), index + 1);
+                    }
+                    break;
+                }
 
-                if constexpr (hasVarArgs()) {
-                    std::cout << "  " ANSI_BOLD "[...]" ANSI_RESET ": " << std::get<varArgsIndex()>(T::Options).description() << '\n';
+                if (token->kind == TokenKind::Positional) {
+                    if (positional >= table.args.size()) {
+                        if (table.varArgs) {
+                            table.varArgs(object, args.subspan(index), index);
+                            break;
+                        }
+                        return fail(ParseError::TooManyArgs, arg, index);
+                    }
+                    std::string_view context = arg;
+                    if (table.args[positional].store(object, arg, context) != ParseError::None) {
+                        auto failed = fail(ParseError::InvalidValue, context, index);
+                        if (context.data() != arg.data()) failed.value = arg; // broke a constraint
+                        return failed;
+                    }
+                    ++positional;
+                    continue;
                 }
-            }
 
-            if constexpr (optionCount() > 0) {
-                std::cout << "\n" ANSI_BOLDLINE "Options:" ANSI_RESET "\n";
+                bool hasEq = token->eq != Token::NoEq;
+                std::string_view name = hasEq ? arg.substr(0, token->eq) : arg;
+                auto slot = findName(table.index, name, token->hash);
+                if (slot == NameSlot::npos && table.abbreviations && token->kind == TokenKind::Long) {
+                    slot = findPrefix(*table.names, table.nameOptions, name);
+                    if (slot == AmbiguousName) {
+                        auto ambiguous = fail(ParseError::AmbiguousOption, name, index);
+                        ambiguous.candidates = table.names;
+                        return ambiguous;
+                    }
+                }
 
-                forEachOption([](auto const& opt) {
-                    if (opt.altName().empty()) {
-                        std::cout << "  " ANSI_BOLD << opt.name() << ANSI_RESET;
-                    } else {
-                        std::cout << "  " ANSI_BOLD << opt.altName() << ", " << opt.name() << ANSI_RESET;
+                if (slot != NameSlot::npos) {
+                    std::string_view value;
+                    if (hasEq) {
+                        value = arg.substr(token->eq + 1);
+                    } else if (table.options[slot].needsValue && !takeValue(tokens, value)) {
+                        return fail(ParseError::MissingValue, name, tokens.index());
                     }
+                    if (auto result = apply(slot, value, arg, name, tokens.index()); !result.isOk()) {
+                        return result;
+                    }
+                    continue;
+                }
 
-                    if constexpr (opt.needsValue()) {
-                        std::cout << " <value>";
+                auto unknown = fail(ParseError::UnknownOption, name, index);
+                unknown.candidates = table.names;
+                if (token->kind != TokenKind::Short || arg.size() <= 2) {
+                    return unknown;
+                }
+
+                // clustered short options, e.g. -abc, -xvf file or -j8
+                for (size_t pos = 1; pos < arg.size(); ++pos) {
+                    char shortName[2] = {'-', arg[pos]};
+                    std::string_view single(shortName, 2);
+                    slot = findName(table.index, single, hashName(single));
+                    if (slot == NameSlot::npos) {
+                        return unknown;
+                    }
+                    if (!table.options[slot].needsValue) {
+                        if (auto result = apply(slot, {}, arg, arg, index); !result.isOk()) {
+                            return result;
+                        }
+                        continue;
                     }
 
-                    if (!opt.description().empty()) {
-                        std::cout << ": " << opt.description();
+                    // the rest of the cluster is the value, otherwise it's the next token
+                    std::string_view value = arg.substr(pos + 1);
+                    if (value.starts_with('=')) {
+                        value.remove_prefix(1);
                     }
-                    std::cout << '\n';
-                });
+                    if (pos + 1 == arg.size() && !takeValue(tokens, value)) {
+                        return fail(ParseError::MissingValue, arg, tokens.index());
+                    }
+                    if (auto result = apply(slot, value, arg, arg, tokens.index()); !result.isOk()) {
+                        return result;
+                    }
+                    break;
+                }
             }
 
-            #undef ANSI_BOLD
-            #undef ANSI_UNDERLINE
-            #undef ANSI_RESET
-            #undef ANSI_BOLDLINE
+            for (uint16_t slot : table.required) {
+                if (!((seen[slot / 64] >> (slot % 64)) & 1)) {
+                    return ParseResult::failure(ParseError::MissingRequiredOption, table.options[slot].name);
+                }
+            }
+            for (size_t i = positional; i < table.args.size(); ++i) {
+                if (table.args[i].required) {
+                    return ParseResult::failure(ParseError::MissingRequiredArg, table.args[i].name);
+                }
+            }
+            return ParseResult::success();
         }
+    } // namespace detail
 
-    private:
-        template <typename F>
-        static constexpr void forEachOption(F&& func) {
-            [&]<size_t... I>(std::index_sequence<I...>){
-                ([&] {
-                    if constexpr (detail::is_option_v<std::tuple_element_t<I, OptsT>>) {
-                        func(std::get<I>(T::Options));
-                    }
-                }(), ...);
-            }(std::make_index_sequence<TupleSize>());
+    /// @brief Argument parser with the same command line syntax as ArgParser, for large options structs.
+    /// T::Options is lowered into a descriptor table at compile time and parsed by one non-template loop,
+    /// which keeps compile time and code size per struct small at the cost of an indirect call per value.
+    /// Subcommands, response files, environment variables and help text need ArgParser.
+    template <class T>
+    class CompactArgParser {
+        using Layout = detail::CompactLayout<T>;
+
+    public:
+        CompactArgParser() = default;
+
+        CompactArgParser(int argc, char const* const* argv) noexcept
+            : m_args(std::span<char const* const>(argv, static_cast<size_t>(argc))) {}
+
+        explicit CompactArgParser(ArgSpan args) noexcept : m_args(args) {}
+
+        [[nodiscard]] T const& result() const noexcept { return m_options; }
+        [[nodiscard]] T& result() noexcept { return m_options; }
+        [[nodiscard]] std::string_view programName() const noexcept {
+            return m_args.empty() ? std::string_view{} : m_args[0];
         }
 
-        template <typename F>
-        static constexpr void forEachArg(F&& func) {
-            [&]<size_t... I>(std::index_sequence<I...>){
-                ([&] {
-                    if constexpr (detail::is_arg_v<std::tuple_element_t<I, OptsT>>) {
-                        func(std::get<I>(T::Options));
-                    }
-                }(), ...);
-            }(std::make_index_sequence<TupleSize>());
+        [[nodiscard]] ParseResult parse() noexcept {
+            detail::BitSet<Layout::OptionCount> seen{};
+            return detail::compactParse(Layout::Table, &m_options, m_args, seen.words);
         }
 
-        enum class IterResult { Continue, Break };
+        /// @brief Resets the result to its defaults and parses args (including the program name).
+        [[nodiscard]] ParseResult parse(std::span<char const* const> args) noexcept {
+            return parse(ArgSpan{args});
+        }
 
-        template <typename F>
-        static constexpr IterResult forEachOptionUntil(F&& func) {
-            IterResult result = IterResult::Continue;
-            [&]<size_t... I>(std::index_sequence<I...>){
-                ([&] {
-                    if (result == IterResult::Break) return;
-                    if constexpr (detail::is_option_v<std::tuple_element_t<I, OptsT>>) {
-                        result = func(std::get<I>(T::Options));
-                    }
-                }(), ...);
-            }(std::make_index_sequence<TupleSize>());
-            return result;
+        /// @copydoc parse(std::span<char const* const>)
+        [[nodiscard]] ParseResult parse(ArgSpan args) noexcept {
+            m_options = T{};
+            m_args = args;
+            return parse();
         }
 
-        template <typename F>
-        static constexpr IterResult forEachArgIndexed(F&& func) {
-            IterResult result = IterResult::Continue;
-            size_t idx = 0;
-            [&]<size_t... I>(std::index_sequence<I...>){
-                ([&] {
-                    if (result == IterResult::Break) return;
-                    if constexpr (detail::is_arg_v<std::tuple_element_t<I, OptsT>>) {
-                        result = func(std::get<I>(T::Options), idx++);
-                    }
-                }(), ...);
-            }(std::make_index_sequence<TupleSize>());
-            return result;
+        /// @brief Splits line into tokens with tokenizer and parses them, the first token being the program name.
+        [[nodiscard]] ParseResult parseString(std::string_view line, Tokenizer& tokenizer) noexcept {
+            if (!tokenizer.tokenize(line)) {
+                return ParseResult::failure(ParseError::TooManyTokens);
+            }
+            return parse(tokenizer.tokens());
         }
 
-        constexpr ParseResult tryParseOption(std::string_view arg, int& index) {
-            // handle --option=value syntax
-            auto eqPos = arg.find('=');
-            std::string_view optName = (eqPos != std::string_view::npos) ? arg.substr(0, eqPos) : arg;
-            std::optional<std::string_view> inlineValue = (eqPos != std::string_view::npos)
-                ? std::optional{arg.substr(eqPos + 1)}
-                : std::nullopt;
+    private:
+        T m_options{};
+        ArgSpan m_args{};
+    };
+
+    /// @brief Holds the parsed options of a long-running process and publishes re-parsed ones to
+    /// reader threads. Readers take a wait-free Snapshot (two atomic increments, no locks). reload()
+    /// parses into a spare slot, publishes it and waits until readers of the previous one are gone,
+    /// like synchronize_rcu(). Based on the Left-Right algorithm (Ramalhete and Correia).
+    /// Snapshots should be short-lived, and the thread calling reload() must not hold one.
+    template <class T>
+    class ConfigHandle {
+        struct alignas(64) ReadIndicator {
+            std::atomic<uint32_t> readers{0};
+        };
+
+        /// @brief A parser with its own copy of the arguments, so views in T stay valid.
+        struct Slot {
+            std::vector<std::string> storage;
+            std::vector<char const*> argv;
+            std::string configPath;
+            ArgParser<T> parser;
+        };
+
+    public:
+        /// @brief Read access to one published T, which stays unchanged while the snapshot lives.
+        class Snapshot {
+        public:
+            Snapshot(Snapshot&& other) noexcept
+                : m_owner(std::exchange(other.m_owner, nullptr)), m_indicator(other.m_indicator), m_value(other.m_value) {}
 
-            ParseResult result = ParseResult::failure(ParseError::UnknownOption, optName);
+            Snapshot(Snapshot const&) = delete;
+            Snapshot& operator=(Snapshot const&) = delete;
+            Snapshot& operator=(Snapshot&&) = delete;
 
-            forEachOptionUntil([&]<typename O>(O const& opt) -> IterResult {
-                if (!opt.matches(optName)) {
-                    return IterResult::Continue;
+            ~Snapshot() {
+                if (m_owner) {
+                    m_owner->depart(*m_indicator);
                 }
+            }
 
-                using FieldType = std::remove_cvref_t<O>::Type;
-                using InnerType = detail::unwrap_optional_t<FieldType>;
+            [[nodiscard]] T const& get() const noexcept { return *m_value; }
+            [[nodiscard]] T const& operator*() const noexcept { return *m_value; }
+            [[nodiscard]] T const* operator->() const noexcept { return m_value; }
 
-                if constexpr (std::is_same_v<InnerType, bool>) {
-                    if (inlineValue) {
-                        auto parsed = ValueParser<bool>::parse(*inlineValue);
-                        if (!parsed) {
-                            result = ParseResult::failure(ParseError::InvalidValue, arg);
-                            return IterResult::Break;
-                        }
-                        m_options.*opt.field() = *parsed;
-                    } else {
-                        m_options.*opt.field() = true;
-                    }
-                    result = ParseResult::success();
-                } else {
-                    std::string_view value;
-                    if (inlineValue) {
-                        value = *inlineValue;
-                    } else if (index + 1 < m_argc) {
-                        value = m_argv[++index];
-                    } else {
-                        result = ParseResult::failure(ParseError::MissingValue, optName);
-                        return IterResult::Break;
-                    }
+        private:
+            friend class ConfigHandle;
 
-                    auto parsed = ValueParser<InnerType>::parse(value);
-                    if (!parsed) {
-                        result = ParseResult::failure(ParseError::InvalidValue, arg);
-                        return IterResult::Break;
-                    }
+            Snapshot(ConfigHandle const* owner, ReadIndicator* indicator, T const* value) noexcept
+                : m_owner(owner), m_indicator(indicator), m_value(value) {}
 
-                    m_options.*opt.field() = *parsed;
-                    result = ParseResult::success();
-                }
+            ConfigHandle const* m_owner;
+            ReadIndicator* m_indicator;
+            T const* m_value;
+        };
 
-                return IterResult::Break;
-            });
+        /// @brief Starts with a default-constructed T, until the first successful reload().
+        ConfigHandle() = default;
 
-            return result;
+        ConfigHandle(ConfigHandle const&) = delete;
+        ConfigHandle& operator=(ConfigHandle const&) = delete;
+
+        /// @brief Returns the latest published T. Wait-free.
+        [[nodiscard]] Snapshot read() const noexcept {
+            ReadIndicator& indicator = m_indicators[m_versionIndex.load()];
+            indicator.readers.fetch_add(1);
+            return Snapshot(this, &indicator, &m_slots[m_leftRight.load()].parser.result());
         }
 
-        constexpr ParseResult tryParsePositional(std::string_view value, size_t targetIndex) noexcept {
-            ParseResult result = ParseResult::failure(ParseError::TooManyArgs, value);
+        /// @brief Parses args (including the program name) into a fresh T and publishes it on success.
+        /// The arguments are copied. On failure the published T stays as it was, and the context of
+        /// the result stays valid until the next reload().
+        ParseResult reload(std::span<char const* const> args) {
+            return publish(args, [](Slot& slot) { return slot.parser.parse(std::span<char const* const>(slot.argv)); });
+        }
 
-            forEachArgIndexed([&]<typename A>(A const& arg, size_t idx) -> IterResult {
-                if (idx != targetIndex) {
-                    return IterResult::Continue;
-                }
+        /// @brief Like reload(args), then fills options that args didn't give from the environment and
+        /// the `name = value` file at configPath, as parseWithConfig() does. The file is re-read on
+        /// every call and stays mapped while its T is published. Needs ConfigFiles in T.
+        ParseResult reload(std::span<char const* const> args, char const* configPath,
+                           char const* const* envp = detail::environment()) {
+            static_assert(detail::config_files_v<T>, "Config files need 'static constexpr bool ConfigFiles = true'");
 
-                using FieldType = std::remove_cvref_t<A>::Type;
-                using InnerType = detail::unwrap_optional_t<FieldType>;
+            std::string path = configPath;
+            return publish(args, [&](Slot& slot) {
+                slot.configPath = std::move(path);
+                slot.parser = ArgParser<T>(ArgSpan{std::span<char const* const>(slot.argv)});
+                return slot.parser.parseWithConfig(slot.configPath.c_str(), envp);
+            });
+        }
 
-                auto parsed = ValueParser<InnerType>::parse(value);
-                if (!parsed) {
-                    result = ParseResult::failure(ParseError::InvalidValue, value);
-                    return IterResult::Break;
-                }
+        /// @brief Asks for a reload, e.g. from a SIGHUP handler. Async-signal-safe.
+        void requestReload() noexcept { m_reloadRequested.store(true); }
 
-                m_options.*arg.field() = *parsed;
-                result = ParseResult::success();
+        /// @brief Whether requestReload() was called since the last call, e.g. in a service's main loop.
+        [[nodiscard]] bool takeReloadRequest() noexcept { return m_reloadRequested.exchange(false); }
 
-                return IterResult::Break;
-            });
+        /// @brief Number of successful reloads.
+        [[nodiscard]] uint64_t version() const noexcept { return m_version.load(); }
 
-            return result;
-        }
+    private:
+        /// @brief Copies args into the unpublished slot, parses it and swaps it in on success.
+        template <typename Parse>
+        ParseResult publish(std::span<char const* const> args, Parse&& parse) {
+            WriterLock lock(m_writing);
 
-        constexpr void setVarArgs(int startIndex) noexcept {
-            if constexpr (hasVarArgs()) {
-                m_options.*std::get<varArgsIndex()>(T::Options).field() = std::span{
-                    m_argv + startIndex,
-                    static_cast<size_t>(m_argc - startIndex)
-                };
+            uint32_t next = 1 - m_leftRight.load();
+            Slot& slot = m_slots[next];
+            slot.storage.assign(args.begin(), args.end());
+            slot.argv.clear();
+            for (auto const& arg : slot.storage) {
+                slot.argv.push_back(arg.c_str());
+            }
+
+            auto result = parse(slot);
+            if (result.isOk()) {
+                m_leftRight.store(next);
+                waitForPreviousReaders();
+                m_version.fetch_add(1);
             }
+            return result;
         }
 
-        [[nodiscard]] constexpr ParseResult checkRequired(size_t count) const noexcept {
-            std::string_view missingArg;
+        struct WriterLock {
+            std::atomic_flag& flag;
 
-            forEachArgIndexed([&]<typename A>(A const& arg, size_t idx) -> IterResult {
-                if constexpr (!A::isOptional()) {
-                    if (idx >= count && missingArg.empty()) {
-                        missingArg = arg.name();
-                        return IterResult::Break;
-                    }
+            explicit WriterLock(std::atomic_flag& f) noexcept : flag(f) {
+                while (flag.test_and_set(std::memory_order_acquire)) {
+                    flag.wait(true);
                 }
-                return IterResult::Continue;
-            });
+            }
 
-            if (!missingArg.empty()) {
-                return ParseResult::failure(ParseError::MissingRequiredArg, missingArg);
+            ~WriterLock() {
+                flag.clear(std::memory_order_release);
+                flag.notify_one();
             }
+        };
 
-            return ParseResult::success();
+        void depart(ReadIndicator& indicator) const noexcept {
+            if (indicator.readers.fetch_sub(1) == 1 && m_writerWaiting.load()) {
+                indicator.readers.notify_all();
+            }
         }
 
-    private:
-        T m_options{};
-        int m_argc{};
-        char const* const* m_argv{};
-        std::string_view m_programName{};
+        /// @brief Moves new readers to the other indicator, and waits until both are empty of readers
+        /// that may have seen the previous slot.
+        void waitForPreviousReaders() noexcept {
+            uint32_t previous = m_versionIndex.load();
+            uint32_t next = 1 - previous;
+            drain(m_indicators[next]);
+            m_versionIndex.store(next);
+            drain(m_indicators[previous]);
+        }
+
+        void drain(ReadIndicator& indicator) noexcept {
+            m_writerWaiting.store(true);
+            for (uint32_t count = indicator.readers.load(); count != 0; count = indicator.readers.load()) {
+                indicator.readers.wait(count);
+            }
+            m_writerWaiting.store(false);
+        }
+
+        std::array<Slot, 2> m_slots{};
+        mutable std::array<ReadIndicator, 2> m_indicators{};
+        std::atomic<uint32_t> m_leftRight{0};
+        std::atomic<uint32_t> m_versionIndex{0};
+        std::atomic<bool> m_writerWaiting{false};
+        std::atomic<bool> m_reloadRequested{false};
+        std::atomic<uint64_t> m_version{0};
+        std::atomic_flag m_writing{};
     };
 } // namespace slic
 
@@ -1,12 +1,21 @@
 #include <slic.hpp>
 #include <gtest/gtest.h>
+#include <cmath>
+#include <cstdio>
 #include <vector>
 #include <string>
+#include <thread>
+#include <variant>
 
 // ============================================================================
 // Test structures
 // ============================================================================
 
+struct StringSink {
+    std::string& out;
+    void write(std::string_view text) { out += text; }
+};
+
 struct SimpleOptions {
     bool verbose = false;
     int count = 0;
@@ -67,6 +76,16 @@ struct VarArgsOptions {
     );
 };
 
+struct TypedVarArgsOptions {
+    std::string_view op;
+    slic::TypedArgSpan<int> values;
+
+    static constexpr auto Options = std::make_tuple(
+        slic::Arg{"op", &TypedVarArgsOptions::op},
+        slic::VarArgs{"Values", &TypedVarArgsOptions::values}
+    );
+};
+
 struct MixedOptions {
     bool debug = false;
     std::optional<int> level;
@@ -83,6 +102,237 @@ struct MixedOptions {
     static constexpr auto Description = "A mixed options test program";
 };
 
+struct PositionalSlots {
+    std::string_view first;
+    int second = 0;
+    std::string_view third;
+    std::optional<std::string_view> fourth;
+
+    static constexpr auto Options = std::make_tuple(
+        slic::Arg{"first", &PositionalSlots::first},
+        slic::Arg{"second", &PositionalSlots::second},
+        slic::Arg{"third", &PositionalSlots::third},
+        slic::Arg{"fourth", &PositionalSlots::fourth}
+    );
+};
+
+struct EnvOptions {
+    int threads = 1;
+    bool verbose = false;
+    std::string_view mode = "auto";
+    std::string_view cluster;
+
+    static constexpr auto Options = std::make_tuple(
+        slic::Option{"--threads", "-t", &EnvOptions::threads, "Worker threads"}.env("APP_THREADS"),
+        slic::Option{"--verbose", "-v", &EnvOptions::verbose}.env("APP_VERBOSE"),
+        slic::Option{"--mode", &EnvOptions::mode}.env("APP_MODE"),
+        slic::Option{"--cluster", &EnvOptions::cluster}
+    );
+};
+
+struct ConstrainedOptions {
+    int threads = 4;
+    double ratio = 0.5;
+    std::string_view name = "default";
+    std::string_view format = "json";
+    int level = 1;
+    std::optional<unsigned> port;
+
+    static constexpr auto Options = std::make_tuple(
+        slic::Option{"--threads", "-t", &ConstrainedOptions::threads, "Worker threads"}.range(1, 256).env("APP_THREADS"),
+        slic::Option{"--ratio", &ConstrainedOptions::ratio}.min(0.25),
+        slic::Option{"--name", &ConstrainedOptions::name}.nonEmpty(),
+        slic::Option{"--format", &ConstrainedOptions::format}.oneOf({"json", "yaml", "toml"}),
+        slic::Option{"--level", &ConstrainedOptions::level}.oneOf({1, 2, 3}),
+        slic::Arg{"port", &ConstrainedOptions::port}.max(65535u)
+    );
+};
+
+struct ResponseFileOptions {
+    bool verbose = false;
+    int count = 0;
+    std::string_view input;
+    slic::ArgSpan rest;
+
+    static constexpr bool ResponseFiles = true;
+    static constexpr auto Options = std::make_tuple(
+        slic::Option{"--verbose", "-v", &ResponseFileOptions::verbose},
+        slic::Option{"--count", "-c", &ResponseFileOptions::count},
+        slic::Arg{"input", &ResponseFileOptions::input},
+        slic::VarArgs{&ResponseFileOptions::rest}
+    );
+};
+
+struct ConfigFileOptions {
+    int threads = 1;
+    bool verbose = false;
+    std::string_view mode = "auto";
+    std::string_view name;
+    slic::Collect<std::string_view, 3> includes;
+
+    static constexpr bool ConfigFiles = true;
+    static constexpr auto Options = std::make_tuple(
+        slic::Option{"--threads", "-t", &ConfigFileOptions::threads}.env("APP_THREADS"),
+        slic::Option{"--verbose", "-v", &ConfigFileOptions::verbose},
+        slic::Option{"--mode", &ConfigFileOptions::mode}.env("APP_MODE"),
+        slic::Option{"--name", "-n", &ConfigFileOptions::name},
+        slic::Option{"--include", "-I", &ConfigFileOptions::includes}
+    );
+};
+
+struct PermuteOptions {
+    bool verbose = false;
+    int count = 0;
+    std::string_view input;
+    slic::ArgSpan rest;
+
+    static constexpr bool Permute = true;
+    static constexpr auto Options = std::make_tuple(
+        slic::Option{"--verbose", "-v", &PermuteOptions::verbose},
+        slic::Option{"--count", "-c", &PermuteOptions::count},
+        slic::Arg{"input", &PermuteOptions::input},
+        slic::VarArgs{&PermuteOptions::rest}
+    );
+};
+
+struct StrictPermuteOptions {
+    bool verbose = false;
+    std::string_view input;
+
+    static constexpr bool Permute = true;
+    static constexpr auto Options = std::make_tuple(
+        slic::Option{"--verbose", &StrictPermuteOptions::verbose},
+        slic::Arg{"input", &StrictPermuteOptions::input}
+    );
+};
+
+struct CollectOptions {
+    slic::Collect<std::string_view, 3> includes;
+    slic::Collect<int, 2> levels;
+    slic::CollectViews<double, 4> weights;
+    bool verbose = false;
+
+    static constexpr auto Options = std::make_tuple(
+        slic::Option{"--include", "-I", &CollectOptions::includes, "Include directory"},
+        slic::Option{"--level", "-l", &CollectOptions::levels},
+        slic::Option{"--weight", "-w", &CollectOptions::weights},
+        slic::Option{"--verbose", "-v", &CollectOptions::verbose}
+    );
+};
+
+struct AddCommand {
+    bool force = false;
+    std::string_view path;
+
+    static constexpr auto Options = std::make_tuple(
+        slic::Option{"--force", "-f", &AddCommand::force},
+        slic::Arg{"path", &AddCommand::path}
+    );
+};
+
+struct CommitCommand {
+    std::string_view message;
+    bool amend = false;
+
+    static constexpr auto Options = std::make_tuple(
+        slic::Option{"--message", "-m", &CommitCommand::message}.env("GIT_MESSAGE"),
+        slic::Option{"--amend", &CommitCommand::amend}
+    );
+};
+
+struct GitOptions {
+    bool verbose = false;
+    std::variant<std::monostate, AddCommand, CommitCommand> command;
+
+    static constexpr auto Options = std::make_tuple(
+        slic::Option{"--verbose", "-v", &GitOptions::verbose, "Verbose output"},
+        slic::Subcommands{&GitOptions::command,
+            slic::Command<AddCommand>{"add", "Add a file"},
+            slic::Command<CommitCommand>{"commit"}}
+    );
+};
+
+struct RequiredOptions {
+    std::string_view cluster;
+    int replicas = 1;
+    bool dryRun = false;
+    std::string_view input;
+
+    static constexpr auto Options = std::make_tuple(
+        slic::Option{"--cluster", "-c", &RequiredOptions::cluster, "Target cluster"}.required(),
+        slic::Option{"--replicas", &RequiredOptions::replicas}.env("REPLICAS").required(),
+        slic::Option{"--dry-run", &RequiredOptions::dryRun},
+        slic::Arg{"input", &RequiredOptions::input}
+    );
+};
+
+enum class Mode { Fast, Safe, Debug };
+
+template <>
+struct slic::EnumTraits<Mode> {
+    static constexpr std::array Names = {
+        std::pair{"fast", Mode::Fast},
+        std::pair{"safe", Mode::Safe},
+        std::pair{"debug", Mode::Debug}
+    };
+};
+
+struct EnumOptions {
+    Mode mode = Mode::Safe;
+    std::optional<Mode> fallback;
+    slic::Collect<Mode, 2> extra;
+
+    static constexpr auto Options = std::make_tuple(
+        slic::Option{"--mode", "-m", &EnumOptions::mode, "Execution mode"},
+        slic::Option{"--fallback", &EnumOptions::fallback},
+        slic::Option{"--extra", &EnumOptions::extra}
+    );
+};
+
+struct CompletionOptions {
+    bool verbose = false;
+    Mode mode = Mode::Safe;
+    int jobs = 1;
+    std::variant<std::monostate, AddCommand, CommitCommand> command;
+
+    static constexpr bool Completion = true;
+    static constexpr auto Options = std::make_tuple(
+        slic::Option{"--verbose", "-v", &CompletionOptions::verbose},
+        slic::Option{"--mode", "-m", &CompletionOptions::mode},
+        slic::Option{"--jobs", "-j", &CompletionOptions::jobs},
+        slic::Subcommands{&CompletionOptions::command,
+            slic::Command<AddCommand>{"add"},
+            slic::Command<CommitCommand>{"commit"}}
+    );
+};
+
+struct AbbreviatedOptions {
+    bool verbose = false;
+    bool version = false;
+    int count = 0;
+    std::string_view color;
+
+    static constexpr bool Abbreviations = true;
+    static constexpr auto Options = std::make_tuple(
+        slic::Option{"--verbose", "-v", &AbbreviatedOptions::verbose},
+        slic::Option{"--version", &AbbreviatedOptions::version},
+        slic::Option{"--count", "-c", &AbbreviatedOptions::count},
+        slic::Option{"--color", "--colour", &AbbreviatedOptions::color}
+    );
+};
+
+struct ServiceOptions {
+    int first = 0;
+    int second = 0;
+    std::string_view tag = "default";
+
+    static constexpr auto Options = std::make_tuple(
+        slic::Option{"--first", &ServiceOptions::first},
+        slic::Option{"--second", &ServiceOptions::second},
+        slic::Option{"--tag", &ServiceOptions::tag}
+    );
+};
+
 struct StringViewOption {
     std::string_view value;
 
@@ -91,6 +341,23 @@ struct StringViewOption {
     );
 };
 
+struct RecordingObserver : slic::NoObserver {
+    std::string events;
+
+    void onToken(size_t index, slic::TokenKind, std::string_view text) {
+        events += "T" + std::to_string(index) + ":" + std::string(text) + " ";
+    }
+    void onOption(size_t index, size_t, std::string_view name) {
+        events += "O" + std::to_string(index) + ":" + std::string(name) + " ";
+    }
+    void onValue(size_t index, std::string_view value, bool ok, uint64_t) {
+        events += "V" + std::to_string(index) + ":" + std::string(value) + (ok ? " " : "! ");
+    }
+    void onError(size_t index, slic::ParseResult const& result) {
+        events += "E" + std::to_string(index) + ":" + std::string(result.context) + " ";
+    }
+};
+
 // ============================================================================
 // Basic Parsing Tests
 // ============================================================================
@@ -317,6 +584,33 @@ TEST(PositionalArgTest, OptionalMissing) {
     EXPECT_FALSE(parser.result().optional.has_value());
 }
 
+TEST(PositionalArgTest, SlotsInOrder) {
+    const char* argv[] = {"program", "a", "2", "c", "d"};
+    slic::ArgParser<PositionalSlots> parser(5, argv);
+    auto result = parser.parse();
+    EXPECT_TRUE(result.isOk());
+    EXPECT_EQ(parser.result().first, "a");
+    EXPECT_EQ(parser.result().second, 2);
+    EXPECT_EQ(parser.result().third, "c");
+    EXPECT_EQ(parser.result().fourth, "d");
+}
+
+TEST(PositionalArgTest, InvalidSlotValue) {
+    const char* argv[] = {"program", "a", "b"};
+    slic::ArgParser<PositionalSlots> parser(3, argv);
+    auto result = parser.parse();
+    EXPECT_EQ(result.error, slic::ParseError::InvalidValue);
+    EXPECT_EQ(result.context, "b");
+}
+
+TEST(PositionalArgTest, MissingMiddleSlot) {
+    const char* argv[] = {"program", "a", "2"};
+    slic::ArgParser<PositionalSlots> parser(3, argv);
+    auto result = parser.parse();
+    EXPECT_EQ(result.error, slic::ParseError::MissingRequiredArg);
+    EXPECT_EQ(result.context, "third");
+}
+
 // ============================================================================
 // VarArgs Tests
 // ============================================================================
@@ -378,196 +672,2162 @@ TEST(VarArgsTest, FrontBack) {
 }
 
 // ============================================================================
-// Error Handling Tests
+// Permute Mode Tests
 // ============================================================================
 
-TEST(ErrorTest, MissingValue) {
-    const char* argv[] = {"program", "--int"};
-    slic::ArgParser<NumericOptions> parser(2, argv);
-    auto result = parser.parse();
-    EXPECT_FALSE(result.isOk());
-    EXPECT_EQ(result.error, slic::ParseError::MissingValue);
-    EXPECT_EQ(result.context, "--int");
+TEST(PermuteTest, OptionsAfterVarArgs) {
+    const char* argv[] = {"program", "a", "b", "c", "-v", "--count", "3", "d"};
+    slic::ArgParser<PermuteOptions> parser(8, argv);
+    ASSERT_TRUE(parser.parse().isOk());
+    EXPECT_TRUE(parser.result().verbose);
+    EXPECT_EQ(parser.result().count, 3);
+    EXPECT_EQ(parser.result().input, "a");
+    EXPECT_EQ(std::vector<std::string_view>(parser.result().rest.begin(), parser.result().rest.end()),
+              (std::vector<std::string_view>{"b", "c", "d"}));
+
+    // non-options end up behind the options, and both keep their original order
+    EXPECT_EQ(parser.result().rest[0].data(), argv[5]);
+    EXPECT_EQ(std::vector<std::string_view>(argv, argv + 8),
+              (std::vector<std::string_view>{"program", "-v", "--count", "3", "a", "b", "c", "d"}));
+
+    // so the permuted argv parses the same way again
+    ASSERT_TRUE(parser.parse().isOk());
+    EXPECT_TRUE(parser.result().verbose);
+    EXPECT_EQ(parser.result().count, 3);
+    EXPECT_EQ(parser.result().input, "a");
+    EXPECT_EQ(std::vector<std::string_view>(parser.result().rest.begin(), parser.result().rest.end()),
+              (std::vector<std::string_view>{"b", "c", "d"}));
+    EXPECT_EQ(std::vector<std::string_view>(argv + 4, argv + 8), (std::vector<std::string_view>{"a", "b", "c", "d"}));
 }
 
-TEST(ErrorTest, InvalidValue) {
-    const char* argv[] = {"program", "--int", "not_a_number"};
-    slic::ArgParser<NumericOptions> parser(3, argv);
-    auto result = parser.parse();
-    EXPECT_FALSE(result.isOk());
-    EXPECT_EQ(result.error, slic::ParseError::InvalidValue);
+TEST(PermuteTest, OptionsKeepTheirValues) {
+    const char* argv[] = {"program", "a", "-c", "3", "b", "-v", "c"};
+    slic::ArgParser<PermuteOptions> parser(7, argv);
+    ASSERT_TRUE(parser.parse().isOk());
+    EXPECT_EQ(std::vector<std::string_view>(argv, argv + 7),
+              (std::vector<std::string_view>{"program", "-c", "3", "-v", "a", "b", "c"}));
+
+    ASSERT_TRUE(parser.parse().isOk());
+    EXPECT_TRUE(parser.result().verbose);
+    EXPECT_EQ(parser.result().count, 3);
+    EXPECT_EQ(parser.result().input, "a");
+    EXPECT_EQ(std::vector<std::string_view>(parser.result().rest.begin(), parser.result().rest.end()),
+              (std::vector<std::string_view>{"b", "c"}));
 }
 
-TEST(ErrorTest, UnknownOption) {
-    const char* argv[] = {"program", "--unknown"};
-    slic::ArgParser<BoolOptions> parser(2, argv);
-    auto result = parser.parse();
-    EXPECT_FALSE(result.isOk());
-    EXPECT_EQ(result.error, slic::ParseError::UnknownOption);
-    EXPECT_EQ(result.context, "--unknown");
+TEST(PermuteTest, SeparatorEndsOptions) {
+    const char* argv[] = {"program", "a", "-c", "2", "b", "--", "-v", "c"};
+    slic::ArgParser<PermuteOptions> parser(8, argv);
+    ASSERT_TRUE(parser.parse().isOk());
+    EXPECT_FALSE(parser.result().verbose);
+    EXPECT_EQ(parser.result().count, 2);
+    EXPECT_EQ(std::vector<std::string_view>(parser.result().rest.begin(), parser.result().rest.end()),
+              (std::vector<std::string_view>{"b", "-v", "c"}));
+
+    // "--" moves in front of the non-options, which fill the Args after it too
+    EXPECT_EQ(std::vector<std::string_view>(argv, argv + 8),
+              (std::vector<std::string_view>{"program", "-c", "2", "--", "a", "b", "-v", "c"}));
+    ASSERT_TRUE(parser.parse().isOk());
+    EXPECT_EQ(parser.result().input, "a");
+    EXPECT_EQ(std::vector<std::string_view>(parser.result().rest.begin(), parser.result().rest.end()),
+              (std::vector<std::string_view>{"b", "-v", "c"}));
 }
 
-TEST(ErrorTest, MissingRequiredArg) {
-    const char* argv[] = {"program"};
-    slic::ArgParser<SimpleOptions> parser(1, argv);
-    auto result = parser.parse();
-    EXPECT_FALSE(result.isOk());
-    EXPECT_EQ(result.error, slic::ParseError::MissingRequiredArg);
-    EXPECT_EQ(result.context, "name");
+TEST(PermuteTest, StringViews) {
+    std::array<std::string_view, 5> args{"program", "a", "b", "--verbose", "c"};
+    slic::ArgParser<PermuteOptions> parser{slic::ArgSpan{std::span<std::string_view const>(args)}};
+    ASSERT_TRUE(parser.parse().isOk());
+    EXPECT_TRUE(parser.result().verbose);
+    EXPECT_EQ(args, (std::array<std::string_view, 5>{"program", "--verbose", "a", "b", "c"}));
+    ASSERT_EQ(parser.result().rest.size(), 2u);
+    EXPECT_EQ(parser.result().rest[1], "c");
 }
 
-TEST(ErrorTest, TooManyArgs) {
-    const char* argv[] = {"program", "arg1", "arg2", "arg3"};
-    slic::ArgParser<OptionalArgOptions> parser(4, argv);
+TEST(PermuteTest, NoVarArgsStillTooMany) {
+    const char* argv[] = {"program", "a", "--verbose", "b"};
+    slic::ArgParser<StrictPermuteOptions> parser(4, argv);
     auto result = parser.parse();
-    EXPECT_FALSE(result.isOk());
     EXPECT_EQ(result.error, slic::ParseError::TooManyArgs);
+    EXPECT_EQ(result.argIndex, 3u);
 }
 
-TEST(ErrorTest, InvalidBoolValue) {
-    const char* argv[] = {"program", "--flag1=invalid"};
-    slic::ArgParser<BoolOptions> parser(2, argv);
-    auto result = parser.parse();
-    EXPECT_FALSE(result.isOk());
-    EXPECT_EQ(result.error, slic::ParseError::InvalidValue);
+TEST(PermuteTest, DisabledByDefault) {
+    const char* argv[] = {"program", "cmd", "a", "-v"};
+    slic::ArgParser<VarArgsOptions> parser(4, argv);
+    ASSERT_TRUE(parser.parse().isOk());
+    ASSERT_EQ(parser.result().args.size(), 2u);
+    EXPECT_EQ(parser.result().args[1], "-v");
 }
 
 // ============================================================================
-// ParseResult Tests
+// Lazy Positional Tests
 // ============================================================================
 
-TEST(ParseResultTest, BoolConversion) {
-    slic::ParseResult success = slic::ParseResult::success();
-    EXPECT_TRUE(static_cast<bool>(success));
+static_assert(std::input_iterator<slic::ArgParser<ResponseFileOptions>::PositionalRange::iterator>);
+static_assert(std::sentinel_for<slic::ArgParser<ResponseFileOptions>::PositionalRange::Sentinel,
+                                slic::ArgParser<ResponseFileOptions>::PositionalRange::iterator>);
+
+TEST(PositionalRangeTest, InterleavesWithOptions) {
+    const char* argv[] = {"program", "input.txt", "a", "-v", "b", "--count", "3", "c", "--", "-x"};
+    slic::ArgParser<ResponseFileOptions> parser(10, argv);
+    auto positionals = parser.positionals();
+
+    std::vector<std::string_view> values;
+    std::vector<bool> verboseAtValue;
+    std::vector<size_t> indices;
+    for (std::string_view value : positionals) {
+        values.push_back(value);
+        verboseAtValue.push_back(parser.result().verbose);
+        indices.push_back(positionals.index());
+    }
+    ASSERT_TRUE(positionals.result().isOk());
+    EXPECT_EQ(values, (std::vector<std::string_view>{"a", "b", "c", "-x"}));
+    EXPECT_EQ(verboseAtValue, (std::vector<bool>{false, true, true, true}));
+    EXPECT_EQ(indices, (std::vector<size_t>{2, 4, 7, 9}));
+    EXPECT_EQ(parser.result().input, "input.txt");
+    EXPECT_EQ(parser.result().count, 3);
+    EXPECT_TRUE(parser.result().rest.empty());
+}
 
-    slic::ParseResult failure = slic::ParseResult::failure(slic::ParseError::UnknownOption);
-    EXPECT_FALSE(static_cast<bool>(failure));
+TEST(PositionalRangeTest, ErrorEndsRange) {
+    const char* argv[] = {"program", "input.txt", "a", "--count", "many", "b"};
+    slic::ArgParser<ResponseFileOptions> parser(6, argv);
+    auto positionals = parser.positionals();
+
+    std::vector<std::string_view> values;
+    for (std::string_view value : positionals) values.push_back(value);
+    EXPECT_EQ(values, (std::vector<std::string_view>{"a"}));
+    EXPECT_EQ(positionals.result().error, slic::ParseError::InvalidValue);
+    EXPECT_EQ(positionals.result().argIndex, 4u);
 }
 
-TEST(ParseResultTest, ErrorMessages) {
-    EXPECT_EQ(slic::ParseResult::success().errorMessage(), "Success");
-    EXPECT_EQ(slic::ParseResult::failure(slic::ParseError::MissingValue).errorMessage(), "Missing value for option");
-    EXPECT_EQ(slic::ParseResult::failure(slic::ParseError::InvalidValue).errorMessage(), "Invalid value");
-    EXPECT_EQ(slic::ParseResult::failure(slic::ParseError::UnknownOption).errorMessage(), "Unknown option");
-    EXPECT_EQ(slic::ParseResult::failure(slic::ParseError::MissingRequiredArg).errorMessage(), "Missing required argument");
-    EXPECT_EQ(slic::ParseResult::failure(slic::ParseError::TooManyArgs).errorMessage(), "Too many arguments");
+TEST(PositionalRangeTest, ChecksRequiredAtEnd) {
+    const char* argv[] = {"program", "-v"};
+    slic::ArgParser<ResponseFileOptions> parser(2, argv);
+    auto positionals = parser.positionals();
+    EXPECT_TRUE(positionals.begin() == positionals.end());
+    EXPECT_EQ(positionals.result().error, slic::ParseError::MissingRequiredArg);
 }
 
-// ============================================================================
-// Program Name Tests
-// ============================================================================
+TEST(PositionalRangeTest, ArgsWithoutVarArgs) {
+    const char* argv[] = {"program", "one", "two", "--verbose"};
+    slic::ArgParser<SimpleOptions> parser(4, argv);
+    auto positionals = parser.positionals();
+    std::vector<std::string_view> values;
+    for (std::string_view value : positionals) values.push_back(value);
+    ASSERT_TRUE(positionals.result().isOk());
+    EXPECT_EQ(parser.result().name, "one");
+    EXPECT_EQ(values, (std::vector<std::string_view>{"two"}));
+    EXPECT_TRUE(parser.result().verbose);
+}
 
-TEST(ProgramNameTest, ExtractFromPath) {
-    const char* argv[] = {"/usr/bin/myprogram"};
-    slic::ArgParser<BoolOptions> parser(1, argv);
-    EXPECT_EQ(parser.programName(), "myprogram");
+TEST(VarArgsTest, TypedLazy) {
+    const char* argv[] = {"program", "sum", "1", "x", "3"};
+    slic::ArgParser<TypedVarArgsOptions> parser(5, argv);
+    ASSERT_TRUE(parser.parse().isOk());
+
+    auto const& values = parser.result().values;
+    ASSERT_EQ(values.size(), 3u);
+    EXPECT_EQ(values[0], 1);
+    EXPECT_EQ(values[1], std::nullopt);
+    EXPECT_EQ(values.raw()[1], "x");
+    std::vector<std::optional<int>> read(values.begin(), values.end());
+    EXPECT_EQ(read, (std::vector<std::optional<int>>{1, std::nullopt, 3}));
 }
 
-TEST(ProgramNameTest, NoPath) {
-    const char* argv[] = {"myprogram"};
-    slic::ArgParser<BoolOptions> parser(1, argv);
-    EXPECT_EQ(parser.programName(), "myprogram");
+TEST(VarArgsTest, TypedConvertInto) {
+    const char* argv[] = {"program", "sum", "--", "1", "-2", "3"};
+    slic::ArgParser<TypedVarArgsOptions> parser(6, argv);
+    ASSERT_TRUE(parser.parse().isOk());
+
+    std::array<int, 3> out{};
+    ASSERT_TRUE(parser.result().values.convertInto(out).isOk());
+    EXPECT_EQ(out, (std::array<int, 3>{1, -2, 3}));
+}
+
+TEST(VarArgsTest, TypedConvertIntoReportsFirstBad) {
+    const char* argv[] = {"program", "sum", "1", "2", "three", "4", "five"};
+    slic::ArgParser<TypedVarArgsOptions> parser(7, argv);
+    ASSERT_TRUE(parser.parse().isOk());
+
+    std::array<int, 5> out{};
+    auto result = parser.result().values.convertInto(out);
+    EXPECT_EQ(result.error, slic::ParseError::InvalidValue);
+    EXPECT_EQ(result.context, "three");
+    EXPECT_EQ(result.argIndex, 4u);
+}
+
+TEST(VarArgsTest, TypedConvertIntoThreads) {
+    std::vector<std::string> storage{"program", "sum"};
+    for (int i = 0; i < 1000; ++i) storage.push_back(std::to_string(i * 3));
+    std::vector<char const*> argv;
+    for (auto const& arg : storage) argv.push_back(arg.c_str());
+
+    slic::ArgParser<TypedVarArgsOptions> parser(static_cast<int>(argv.size()), argv.data());
+    ASSERT_TRUE(parser.parse().isOk());
+    auto const& values = parser.result().values;
+
+    for (size_t threads : {1u, 3u, 8u, 5000u}) {
+        std::vector<int> out(values.size());
+        ASSERT_TRUE(values.convertInto<std::thread>(out, threads).isOk()) << threads;
+        for (size_t i = 0; i < out.size(); ++i) ASSERT_EQ(out[i], static_cast<int>(i) * 3);
+    }
+
+    // the earliest bad value wins even when a later chunk also fails
+    storage[900] = "bad900";
+    storage[100] = "bad100";
+    argv[900] = storage[900].c_str();
+    argv[100] = storage[100].c_str();
+    std::vector<int> out(values.size());
+    auto result = values.convertInto<std::thread>(out, 4);
+    EXPECT_EQ(result.error, slic::ParseError::InvalidValue);
+    EXPECT_EQ(result.context, "bad100");
+    EXPECT_EQ(result.argIndex, 100u);
+}
+
+TEST(VarArgsTest, TypedEmpty) {
+    const char* argv[] = {"program", "sum"};
+    slic::ArgParser<TypedVarArgsOptions> parser(2, argv);
+    ASSERT_TRUE(parser.parse().isOk());
+    EXPECT_TRUE(parser.result().values.empty());
+    std::vector<int> out;
+    EXPECT_TRUE(parser.result().values.convertInto<std::thread>(out, 4).isOk());
+}
+
+TEST(VarArgsTest, TypedCompact) {
+    const char* argv[] = {"program", "sum", "1", "2"};
+    slic::CompactArgParser<TypedVarArgsOptions> parser(4, argv);
+    ASSERT_TRUE(parser.parse().isOk());
+    ASSERT_EQ(parser.result().values.size(), 2u);
+    EXPECT_EQ(parser.result().values[1], 2);
+
+    std::array<int, 2> out{};
+    argv[3] = "z";
+    auto result = parser.result().values.convertInto(out);
+    EXPECT_EQ(result.argIndex, 3u);
 }
 
 // ============================================================================
-// Mixed/Complex Scenarios Tests
+// Short Option Cluster Tests
 // ============================================================================
 
-TEST(MixedOptionsTest, Full) {
-    const char* argv[] = {"program", "-d", "--level=5", "input.txt", "output.txt"};
-    slic::ArgParser<MixedOptions> parser(5, argv);
+TEST(ShortClusterTest, Flags) {
+    const char* argv[] = {"program", "-ab"};
+    slic::ArgParser<BoolOptions> parser(2, argv);
     auto result = parser.parse();
     EXPECT_TRUE(result.isOk());
-    EXPECT_TRUE(parser.result().debug);
-    ASSERT_TRUE(parser.result().level.has_value());
-    EXPECT_EQ(*parser.result().level, 5);
-    EXPECT_EQ(parser.result().input, "input.txt");
-    ASSERT_TRUE(parser.result().output.has_value());
-    EXPECT_EQ(*parser.result().output, "output.txt");
+    EXPECT_TRUE(parser.result().flag1);
+    EXPECT_TRUE(parser.result().flag2);
+    EXPECT_FALSE(parser.result().optFlag.has_value());
 }
 
-TEST(MixedOptionsTest, Partial) {
-    const char* argv[] = {"program", "input.txt"};
-    slic::ArgParser<MixedOptions> parser(2, argv);
+TEST(ShortClusterTest, TrailingValueInline) {
+    const char* argv[] = {"program", "-vc8", "myname"};
+    slic::ArgParser<SimpleOptions> parser(3, argv);
     auto result = parser.parse();
     EXPECT_TRUE(result.isOk());
-    EXPECT_FALSE(parser.result().debug);
-    EXPECT_FALSE(parser.result().level.has_value());
-    EXPECT_EQ(parser.result().input, "input.txt");
-    EXPECT_FALSE(parser.result().output.has_value());
+    EXPECT_TRUE(parser.result().verbose);
+    EXPECT_EQ(parser.result().count, 8);
+    EXPECT_EQ(parser.result().name, "myname");
 }
 
-TEST(MixedOptionsTest, OptionalBoolOption) {
-    const char* argv[] = {"program", "--opt-flag=true"};
-    slic::ArgParser<BoolOptions> parser(2, argv);
+TEST(ShortClusterTest, TrailingValueNextToken) {
+    const char* argv[] = {"program", "-vc", "8", "myname"};
+    slic::ArgParser<SimpleOptions> parser(4, argv);
     auto result = parser.parse();
     EXPECT_TRUE(result.isOk());
-    ASSERT_TRUE(parser.result().optFlag.has_value());
-    EXPECT_TRUE(*parser.result().optFlag);
+    EXPECT_TRUE(parser.result().verbose);
+    EXPECT_EQ(parser.result().count, 8);
+    EXPECT_EQ(parser.result().name, "myname");
 }
 
-// ============================================================================
-// Static Compile-Time Tests
-// ============================================================================
+TEST(ShortClusterTest, TrailingValueEquals) {
+    const char* argv[] = {"program", "-vc=8", "myname"};
+    slic::ArgParser<SimpleOptions> parser(3, argv);
+    auto result = parser.parse();
+    EXPECT_TRUE(result.isOk());
+    EXPECT_EQ(parser.result().count, 8);
+}
 
-TEST(StaticTest, OptionCount) {
-    constexpr auto count = slic::ArgParser<SimpleOptions>::optionCount();
+TEST(ShortClusterTest, MissingValue) {
+    const char* argv[] = {"program", "-vc"};
+    slic::ArgParser<SimpleOptions> parser(2, argv);
+    auto result = parser.parse();
+    EXPECT_EQ(result.error, slic::ParseError::MissingValue);
+    EXPECT_EQ(result.context, "-vc");
+}
+
+TEST(ShortClusterTest, UnknownFlag) {
+    const char* argv[] = {"program", "-axb"};
+    slic::ArgParser<BoolOptions> parser(2, argv);
+    auto result = parser.parse();
+    EXPECT_EQ(result.error, slic::ParseError::UnknownOption);
+    EXPECT_EQ(result.context, "-axb");
+}
+
+// ============================================================================
+// Environment Fallback Tests
+// ============================================================================
+
+TEST(EnvTest, FillsUnsetOptions) {
+    const char* argv[] = {"program"};
+    const char* envp[] = {"PATH=/usr/bin", "APP_THREADS=8", "APP_VERBOSE=yes", "APP_MODE=fast", nullptr};
+    slic::ArgParser<EnvOptions> parser(1, argv);
+    auto result = parser.parseWithEnv(envp);
+    EXPECT_TRUE(result.isOk());
+    EXPECT_EQ(parser.result().threads, 8);
+    EXPECT_TRUE(parser.result().verbose);
+    EXPECT_EQ(parser.result().mode, "fast");
+}
+
+TEST(EnvTest, CommandLineTakesPrecedence) {
+    const char* argv[] = {"program", "--threads", "2", "--mode=safe"};
+    const char* envp[] = {"APP_THREADS=8", "APP_MODE=fast", nullptr};
+    slic::ArgParser<EnvOptions> parser(4, argv);
+    auto result = parser.parseWithEnv(envp);
+    EXPECT_TRUE(result.isOk());
+    EXPECT_EQ(parser.result().threads, 2);
+    EXPECT_EQ(parser.result().mode, "safe");
+}
+
+TEST(EnvTest, InvalidValue) {
+    const char* argv[] = {"program"};
+    const char* envp[] = {"APP_THREADS=many", nullptr};
+    slic::ArgParser<EnvOptions> parser(1, argv);
+    auto result = parser.parseWithEnv(envp);
+    EXPECT_EQ(result.error, slic::ParseError::InvalidValue);
+    EXPECT_EQ(result.context, "APP_THREADS=many");
+}
+
+TEST(EnvTest, IgnoredByPlainParse) {
+    setenv("APP_THREADS", "16", 1);
+    const char* argv[] = {"program"};
+    slic::ArgParser<EnvOptions> parser(1, argv);
+    EXPECT_TRUE(parser.parse().isOk());
+    EXPECT_EQ(parser.result().threads, 1);
+
+    slic::ArgParser<EnvOptions> envParser(1, argv);
+    EXPECT_TRUE(envParser.parseWithEnv().isOk());
+    EXPECT_EQ(envParser.result().threads, 16);
+    unsetenv("APP_THREADS");
+}
+
+TEST(EnvTest, ShownInHelp) {
+    const char* argv[] = {"program"};
+    slic::ArgParser<EnvOptions> parser(1, argv);
+    auto body = parser.helpText(false).body;
+    EXPECT_NE(body.find("  -t, --threads <value>: Worker threads [env: APP_THREADS]\n"), std::string_view::npos);
+}
+
+// ============================================================================
+// Repeated Option Tests
+// ============================================================================
+
+TEST(CollectTest, CollectsAllForms) {
+    const char* argv[] = {"program", "-I", "a", "--include=b", "-vIc", "-l", "1", "--level", "2"};
+    slic::ArgParser<CollectOptions> parser(9, argv);
+    auto result = parser.parse();
+    ASSERT_TRUE(result.isOk());
+
+    auto const& includes = parser.result().includes;
+    ASSERT_EQ(includes.size(), 3u);
+    EXPECT_EQ(includes[0], "a");
+    EXPECT_EQ(includes[1], "b");
+    EXPECT_EQ(includes[2], "c");
+    EXPECT_TRUE(parser.result().verbose);
+
+    std::vector<int> levels(parser.result().levels.begin(), parser.result().levels.end());
+    EXPECT_EQ(levels, (std::vector<int>{1, 2}));
+}
+
+TEST(CollectTest, Empty) {
+    const char* argv[] = {"program"};
+    slic::ArgParser<CollectOptions> parser(1, argv);
+    ASSERT_TRUE(parser.parse().isOk());
+    EXPECT_TRUE(parser.result().includes.empty());
+    EXPECT_TRUE(parser.result().weights.empty());
+}
+
+TEST(CollectTest, Overflow) {
+    const char* argv[] = {"program", "-l", "1", "-l", "2", "-l", "3"};
+    slic::ArgParser<CollectOptions> parser(7, argv);
+    auto result = parser.parse();
+    EXPECT_EQ(result.error, slic::ParseError::TooManyValues);
+    EXPECT_EQ(result.context, "-l");
+}
+
+TEST(CollectTest, InvalidValue) {
+    const char* argv[] = {"program", "--level=x"};
+    slic::ArgParser<CollectOptions> parser(2, argv);
+    EXPECT_EQ(parser.parse().error, slic::ParseError::InvalidValue);
+}
+
+TEST(CollectTest, ViewsConvertOnAccess) {
+    const char* argv[] = {"program", "-w", "0.5", "--weight=2"};
+    slic::ArgParser<CollectOptions> parser(4, argv);
+    ASSERT_TRUE(parser.parse().isOk());
+
+    auto const& weights = parser.result().weights;
+    ASSERT_EQ(weights.size(), 2u);
+    EXPECT_EQ(weights.view(0), "0.5");
+    EXPECT_DOUBLE_EQ(weights[0], 0.5);
+
+    std::vector<double> values(weights.begin(), weights.end());
+    EXPECT_EQ(values, (std::vector<double>{0.5, 2.0}));
+}
+
+TEST(CollectTest, ViewsValidated) {
+    const char* argv[] = {"program", "-w", "heavy"};
+    slic::ArgParser<CollectOptions> parser(3, argv);
+    EXPECT_EQ(parser.parse().error, slic::ParseError::InvalidValue);
+}
+
+TEST(CollectTest, ShownInHelp) {
+    const char* argv[] = {"program"};
+    slic::ArgParser<CollectOptions> parser(1, argv);
+    auto body = parser.helpText(false).body;
+    EXPECT_NE(body.find("  -I, --include <value>...: Include directory\n"), std::string_view::npos);
+}
+
+// ============================================================================
+// Response File Tests
+// ============================================================================
+
+class ResponseFileTest : public testing::Test {
+protected:
+    void TearDown() override {
+        for (auto const& path : m_paths) std::remove(path.c_str());
+    }
+
+    std::string write(std::string const& contents) {
+        std::string path = testing::TempDir() + "slic_rsp_" + std::to_string(m_paths.size()) + ".rsp";
+        std::FILE* file = std::fopen(path.c_str(), "wb");
+        std::fwrite(contents.data(), 1, contents.size(), file);
+        std::fclose(file);
+        m_paths.push_back(path);
+        return "@" + path;
+    }
+
+private:
+    std::vector<std::string> m_paths;
+};
+
+TEST_F(ResponseFileTest, Expands) {
+    auto rsp = write("--count 3\n  input.txt\textra1 extra2\n");
+    const char* argv[] = {"program", "-v", rsp.c_str(), "extra3"};
+    slic::ArgParser<ResponseFileOptions> parser(4, argv);
+    auto result = parser.parse();
+    ASSERT_TRUE(result.isOk());
+    EXPECT_TRUE(parser.result().verbose);
+    EXPECT_EQ(parser.result().count, 3);
+    EXPECT_EQ(parser.result().input, "input.txt");
+    ASSERT_EQ(parser.result().rest.size(), 3u);
+    EXPECT_EQ(parser.result().rest[0], "extra1");
+    EXPECT_EQ(parser.result().rest[1], "extra2");
+    EXPECT_EQ(parser.result().rest[2], "extra3");
+}
+
+TEST_F(ResponseFileTest, ReusedParser) {
+    auto first = write("--count 3 first.txt");
+    auto second = write("second.txt");
+    const char* argv1[] = {"program", first.c_str()};
+    const char* argv2[] = {"program", second.c_str()};
+
+    slic::ArgParser<ResponseFileOptions> parser;
+    ASSERT_TRUE(parser.parse(argv1).isOk());
+    EXPECT_EQ(parser.result().input, "first.txt");
+    ASSERT_TRUE(parser.parse(argv2).isOk());
+    EXPECT_EQ(parser.result().input, "second.txt");
+    EXPECT_EQ(parser.result().count, 0);
+}
+
+TEST_F(ResponseFileTest, QuotesAndEscapes) {
+    auto rsp = write("\"with spaces.txt\" 'single \\ quoted' escaped\\ space \"\" mi\"x\"ed");
+    const char* argv[] = {"program", rsp.c_str()};
+    slic::ArgParser<ResponseFileOptions> parser(2, argv);
+    ASSERT_TRUE(parser.parse().isOk());
+    EXPECT_EQ(parser.result().input, "with spaces.txt");
+    ASSERT_EQ(parser.result().rest.size(), 4u);
+    EXPECT_EQ(parser.result().rest[0], "single \\ quoted");
+    EXPECT_EQ(parser.result().rest[1], "escaped space");
+    EXPECT_EQ(parser.result().rest[2], "");
+    EXPECT_EQ(parser.result().rest[3], "mixed");
+}
+
+TEST_F(ResponseFileTest, PageSizedFile) {
+    std::string contents(4096, 'x');
+    contents[0] = '-';
+    contents[1] = 'v';
+    contents[2] = ' ';
+    auto rsp = write(contents);
+    const char* argv[] = {"program", rsp.c_str()};
+    slic::ArgParser<ResponseFileOptions> parser(2, argv);
+    ASSERT_TRUE(parser.parse().isOk());
+    EXPECT_TRUE(parser.result().verbose);
+    EXPECT_EQ(parser.result().input, contents.substr(3));
+}
+
+TEST_F(ResponseFileTest, EmptyFile) {
+    auto rsp = write("");
+    const char* argv[] = {"program", rsp.c_str(), "input.txt"};
+    slic::ArgParser<ResponseFileOptions> parser(3, argv);
+    ASSERT_TRUE(parser.parse().isOk());
+    EXPECT_EQ(parser.result().input, "input.txt");
+}
+
+TEST_F(ResponseFileTest, NotExpandedAfterSeparator) {
+    auto rsp = write("-v");
+    const char* argv[] = {"program", "input.txt", "--", rsp.c_str()};
+    slic::ArgParser<ResponseFileOptions> parser(4, argv);
+    ASSERT_TRUE(parser.parse().isOk());
+    EXPECT_FALSE(parser.result().verbose);
+    ASSERT_EQ(parser.result().rest.size(), 1u);
+    EXPECT_EQ(parser.result().rest[0], rsp);
+}
+
+TEST_F(ResponseFileTest, MissingFile) {
+    const char* argv[] = {"program", "@/nonexistent/slic.rsp"};
+    slic::ArgParser<ResponseFileOptions> parser(2, argv);
+    auto result = parser.parse();
+    EXPECT_EQ(result.error, slic::ParseError::InvalidResponseFile);
+    EXPECT_EQ(result.context, "@/nonexistent/slic.rsp");
+}
+
+TEST_F(ResponseFileTest, DisabledByDefault) {
+    const char* argv[] = {"program", "@args.rsp"};
+    slic::ArgParser<SimpleOptions> parser(2, argv);
+    ASSERT_TRUE(parser.parse().isOk());
+    EXPECT_EQ(parser.result().name, "@args.rsp");
+}
+
+// ============================================================================
+// Config File Tests
+// ============================================================================
+
+class ConfigFileTest : public testing::Test {
+protected:
+    void TearDown() override {
+        for (auto const& path : m_paths) std::remove(path.c_str());
+    }
+
+    std::string write(std::string const& contents) {
+        std::string path = testing::TempDir() + "slic_config_" + std::to_string(m_paths.size()) + ".conf";
+        std::FILE* file = std::fopen(path.c_str(), "wb");
+        std::fwrite(contents.data(), 1, contents.size(), file);
+        std::fclose(file);
+        m_paths.push_back(path);
+        return path;
+    }
+
+    static constexpr char const* NoEnv[] = {nullptr};
+
+private:
+    std::vector<std::string> m_paths;
+};
+
+TEST_F(ConfigFileTest, FillsUnsetOptions) {
+    auto path = write("# service config\n"
+                      "threads = 4\n"
+                      "\n"
+                      "  verbose\n"
+                      "mode=safe\r\n"
+                      "name = \"  padded  \"\n"
+                      "include = /usr/include\n"
+                      "include = /opt/include");
+    const char* argv[] = {"program"};
+    slic::ArgParser<ConfigFileOptions> parser(1, argv);
+    auto result = parser.parseWithConfig(path.c_str(), NoEnv);
+    ASSERT_TRUE(result.isOk()) << result.context;
+    EXPECT_EQ(parser.result().threads, 4);
+    EXPECT_TRUE(parser.result().verbose);
+    EXPECT_EQ(parser.result().mode, "safe");
+    EXPECT_EQ(parser.result().name, "  padded  ");
+    ASSERT_EQ(parser.result().includes.size(), 2u);
+    EXPECT_EQ(parser.result().includes[0], "/usr/include");
+    EXPECT_EQ(parser.result().includes[1], "/opt/include");
+}
+
+TEST_F(ConfigFileTest, Precedence) {
+    auto path = write("threads = 4\nmode = safe\nname = file\ninclude = /file\n");
+    const char* argv[] = {"program", "--name", "argv", "-I", "/argv"};
+    const char* envp[] = {"APP_THREADS=8", "APP_MODE=debug", nullptr};
+    slic::ArgParser<ConfigFileOptions> parser(5, argv);
+    ASSERT_TRUE(parser.parseWithConfig(path.c_str(), envp).isOk());
+    EXPECT_EQ(parser.result().threads, 8);
+    EXPECT_EQ(parser.result().mode, "debug");
+    EXPECT_EQ(parser.result().name, "argv");
+    ASSERT_EQ(parser.result().includes.size(), 1u);
+    EXPECT_EQ(parser.result().includes[0], "/argv");
+}
+
+TEST_F(ConfigFileTest, ShortNameKey) {
+    auto path = write("n = short\n");
+    const char* argv[] = {"program"};
+    slic::ArgParser<ConfigFileOptions> parser(1, argv);
+    ASSERT_TRUE(parser.parseWithConfig(path.c_str(), NoEnv).isOk());
+    EXPECT_EQ(parser.result().name, "short");
+}
+
+TEST_F(ConfigFileTest, ViewsOutliveTheFile) {
+    auto path = write("name = mapped\n");
+    const char* argv[] = {"program"};
+    slic::ArgParser<ConfigFileOptions> parser(1, argv);
+    ASSERT_TRUE(parser.parseWithConfig(path.c_str(), NoEnv).isOk());
+    std::remove(path.c_str());
+    EXPECT_EQ(parser.result().name, "mapped");
+}
+
+TEST_F(ConfigFileTest, UnknownKey) {
+    auto path = write("threads = 2\nverbos = true\n");
+    const char* argv[] = {"program"};
+    slic::ArgParser<ConfigFileOptions> parser(1, argv);
+    auto result = parser.parseWithConfig(path.c_str(), NoEnv);
+    EXPECT_EQ(result.error, slic::ParseError::UnknownOption);
+    EXPECT_EQ(result.context, "verbos");
+    EXPECT_EQ(result.argIndex, slic::ParseResult::NoArgIndex);
+    auto suggestions = result.suggestions();
+    ASSERT_EQ(suggestions.size(), 1u);
+    EXPECT_EQ(suggestions[0], "--verbose");
+}
+
+TEST_F(ConfigFileTest, InvalidValue) {
+    auto path = write("threads = many\n");
+    const char* argv[] = {"program"};
+    slic::ArgParser<ConfigFileOptions> parser(1, argv);
+    auto result = parser.parseWithConfig(path.c_str(), NoEnv);
+    EXPECT_EQ(result.error, slic::ParseError::InvalidValue);
+    EXPECT_EQ(result.context, "threads = many");
+}
+
+TEST_F(ConfigFileTest, MissingValue) {
+    auto path = write("mode\n");
+    const char* argv[] = {"program"};
+    slic::ArgParser<ConfigFileOptions> parser(1, argv);
+    auto result = parser.parseWithConfig(path.c_str(), NoEnv);
+    EXPECT_EQ(result.error, slic::ParseError::MissingValue);
+    EXPECT_EQ(result.context, "mode");
+}
+
+TEST_F(ConfigFileTest, MissingFile) {
+    const char* argv[] = {"program"};
+    slic::ArgParser<ConfigFileOptions> parser(1, argv);
+    auto result = parser.parseWithConfig("/nonexistent/slic.conf", NoEnv);
+    EXPECT_EQ(result.error, slic::ParseError::InvalidConfigFile);
+    EXPECT_EQ(result.context, "/nonexistent/slic.conf");
+}
+
+TEST_F(ConfigFileTest, ReusedParser) {
+    auto first = write("name = first\n");
+    auto second = write("threads = 3\n");
+    const char* argv[] = {"program"};
+    slic::ArgParser<ConfigFileOptions> parser(1, argv);
+    ASSERT_TRUE(parser.parseWithConfig(first.c_str(), NoEnv).isOk());
+    EXPECT_EQ(parser.result().name, "first");
+    ASSERT_TRUE(parser.parse(std::span<char const* const>(argv)).isOk());
+    ASSERT_TRUE(parser.parseWithConfig(second.c_str(), NoEnv).isOk());
+    EXPECT_EQ(parser.result().name, "");
+    EXPECT_EQ(parser.result().threads, 3);
+}
+
+TEST_F(ConfigFileTest, ReloadsChangedFile) {
+    auto path = write("threads = 2\nname = first\n");
+    const char* argv[] = {"program"};
+    slic::ArgParser<ConfigFileOptions> parser(1, argv);
+    ASSERT_TRUE(parser.parseWithConfig(path.c_str(), NoEnv).isOk());
+    EXPECT_EQ(parser.result().threads, 2);
+    EXPECT_EQ(parser.result().name, "first");
+
+    // rewritten in place, so the old mapping is gone once the file is opened again
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    std::fputs("threads = 4\nname = second\n", file);
+    std::fclose(file);
+    ASSERT_TRUE(parser.parseWithConfig(path.c_str(), NoEnv).isOk());
+    EXPECT_EQ(parser.result().threads, 4);
+    EXPECT_EQ(parser.result().name, "second");
+
+    std::remove(path.c_str());
+    EXPECT_EQ(parser.parseWithConfig(path.c_str(), NoEnv).error, slic::ParseError::InvalidConfigFile);
+    EXPECT_EQ(parser.result().threads, 1);
+    EXPECT_EQ(parser.result().name, "");
+}
+
+// ============================================================================
+// Error Handling Tests
+// ============================================================================
+
+TEST(ErrorTest, MissingValue) {
+    const char* argv[] = {"program", "--int"};
+    slic::ArgParser<NumericOptions> parser(2, argv);
+    auto result = parser.parse();
+    EXPECT_FALSE(result.isOk());
+    EXPECT_EQ(result.error, slic::ParseError::MissingValue);
+    EXPECT_EQ(result.context, "--int");
+}
+
+TEST(ErrorTest, InvalidValue) {
+    const char* argv[] = {"program", "--int", "not_a_number"};
+    slic::ArgParser<NumericOptions> parser(3, argv);
+    auto result = parser.parse();
+    EXPECT_FALSE(result.isOk());
+    EXPECT_EQ(result.error, slic::ParseError::InvalidValue);
+}
+
+TEST(ErrorTest, UnknownOption) {
+    const char* argv[] = {"program", "--unknown"};
+    slic::ArgParser<BoolOptions> parser(2, argv);
+    auto result = parser.parse();
+    EXPECT_FALSE(result.isOk());
+    EXPECT_EQ(result.error, slic::ParseError::UnknownOption);
+    EXPECT_EQ(result.context, "--unknown");
+}
+
+TEST(ErrorTest, UnknownOptionPrefix) {
+    const char* argv[] = {"program", "--flag"};
+    slic::ArgParser<BoolOptions> parser(2, argv);
+    auto result = parser.parse();
+    EXPECT_EQ(result.error, slic::ParseError::UnknownOption);
+    EXPECT_EQ(result.context, "--flag");
+}
+
+TEST(ErrorTest, MissingRequiredArg) {
+    const char* argv[] = {"program"};
+    slic::ArgParser<SimpleOptions> parser(1, argv);
+    auto result = parser.parse();
+    EXPECT_FALSE(result.isOk());
+    EXPECT_EQ(result.error, slic::ParseError::MissingRequiredArg);
+    EXPECT_EQ(result.context, "name");
+}
+
+TEST(ErrorTest, TooManyArgs) {
+    const char* argv[] = {"program", "arg1", "arg2", "arg3"};
+    slic::ArgParser<OptionalArgOptions> parser(4, argv);
+    auto result = parser.parse();
+    EXPECT_FALSE(result.isOk());
+    EXPECT_EQ(result.error, slic::ParseError::TooManyArgs);
+}
+
+TEST(ErrorTest, InvalidBoolValue) {
+    const char* argv[] = {"program", "--flag1=invalid"};
+    slic::ArgParser<BoolOptions> parser(2, argv);
+    auto result = parser.parse();
+    EXPECT_FALSE(result.isOk());
+    EXPECT_EQ(result.error, slic::ParseError::InvalidValue);
+}
+
+// ============================================================================
+// ParseResult Tests
+// ============================================================================
+
+TEST(ParseResultTest, BoolConversion) {
+    slic::ParseResult success = slic::ParseResult::success();
+    EXPECT_TRUE(static_cast<bool>(success));
+
+    slic::ParseResult failure = slic::ParseResult::failure(slic::ParseError::UnknownOption);
+    EXPECT_FALSE(static_cast<bool>(failure));
+}
+
+TEST(ParseResultTest, ErrorMessages) {
+    EXPECT_EQ(slic::ParseResult::success().errorMessage(), "Success");
+    EXPECT_EQ(slic::ParseResult::failure(slic::ParseError::MissingValue).errorMessage(), "Missing value for option");
+    EXPECT_EQ(slic::ParseResult::failure(slic::ParseError::InvalidValue).errorMessage(), "Invalid value");
+    EXPECT_EQ(slic::ParseResult::failure(slic::ParseError::UnknownOption).errorMessage(), "Unknown option");
+    EXPECT_EQ(slic::ParseResult::failure(slic::ParseError::MissingRequiredArg).errorMessage(), "Missing required argument");
+    EXPECT_EQ(slic::ParseResult::failure(slic::ParseError::TooManyArgs).errorMessage(), "Too many arguments");
+    EXPECT_EQ(slic::ParseResult::failure(slic::ParseError::InvalidResponseFile).errorMessage(), "Cannot read response file");
+    EXPECT_EQ(slic::ParseResult::failure(slic::ParseError::TooManyValues).errorMessage(), "Too many values for option");
+    EXPECT_EQ(slic::ParseResult::failure(slic::ParseError::UnknownCommand).errorMessage(), "Unknown command");
+    EXPECT_EQ(slic::ParseResult::failure(slic::ParseError::TooManyTokens).errorMessage(),
+              "Command line doesn't fit the tokenizer buffers");
+    EXPECT_EQ(slic::ParseResult::failure(slic::ParseError::MissingRequiredOption).errorMessage(),
+              "Missing required option");
+    EXPECT_EQ(slic::ParseResult::failure(slic::ParseError::AmbiguousOption).errorMessage(), "Ambiguous option");
+    EXPECT_EQ(slic::ParseResult::failure(slic::ParseError::InvalidConfigFile).errorMessage(), "Cannot read config file");
+    EXPECT_EQ(slic::ParseResult::failure(slic::ParseError::CompletionWritten).errorMessage(),
+              "Shell completions were written");
+}
+
+TEST(ParseResultTest, PrintToSink) {
+    std::string out;
+    slic::ParseResult::failure(slic::ParseError::UnknownOption, "--foo").print(StringSink{out});
+    EXPECT_EQ(out, "Error: Unknown option '--foo'\n");
+
+    out.clear();
+    slic::ParseResult::failure(slic::ParseError::TooManyArgs).print(StringSink{out});
+    EXPECT_EQ(out, "Error: Too many arguments\n");
+
+    out.clear();
+    slic::ParseResult::success().print(StringSink{out});
+    EXPECT_TRUE(out.empty());
+}
+
+TEST(ParseResultTest, ArgIndex) {
+    const char* argv[] = {"program", "-i", "1", "--long", "x"};
+    slic::ArgParser<NumericOptions> parser(5, argv);
+    auto result = parser.parse();
+    EXPECT_EQ(result.error, slic::ParseError::InvalidValue);
+    EXPECT_EQ(result.argIndex, 4u);
+
+    const char* missing[] = {"program", "--int"};
+    EXPECT_EQ(parser.parse(std::span{missing}).argIndex, 1u);
+
+    const char* ok[] = {"program", "-i", "1"};
+    EXPECT_EQ(parser.parse(std::span{ok}).argIndex, slic::ParseResult::NoArgIndex);
+}
+
+TEST(ParseResultTest, ArgIndexInSubcommand) {
+    const char* argv[] = {"git", "-v", "add", "--forse"};
+    slic::ArgParser<GitOptions> parser(4, argv);
+    auto result = parser.parse();
+    EXPECT_EQ(result.error, slic::ParseError::UnknownOption);
+    EXPECT_EQ(result.argIndex, 3u);
+}
+
+TEST(ParseResultTest, Suggestions) {
+    const char* argv[] = {"program", "--flot", "1"};
+    slic::ArgParser<NumericOptions> parser(3, argv);
+    auto result = parser.parse();
+    auto similar = result.suggestions();
+    ASSERT_EQ(similar.size(), 1u);
+    EXPECT_EQ(similar[0], "--float");
+
+    std::string out;
+    result.print(StringSink{out});
+    EXPECT_EQ(out, "Error: Unknown option '--flot'\nDid you mean '--float'?\n");
+}
+
+TEST(ParseResultTest, SuggestionsByDistance) {
+    const char* argv[] = {"program", "--in"};
+    slic::ArgParser<NumericOptions> parser(2, argv);
+    auto similar = parser.parse().suggestions();
+    ASSERT_EQ(similar.size(), 1u);
+    EXPECT_EQ(similar[0], "--int");
+
+    const char* swapped[] = {"program", "--uitn"};
+    similar = parser.parse(std::span{swapped}).suggestions();
+    ASSERT_EQ(similar.size(), 1u);
+    EXPECT_EQ(similar[0], "--uint");
+
+    const char* between[] = {"program", "--unt"};
+    std::string out;
+    parser.parse(std::span{between}).print(StringSink{out});
+    EXPECT_EQ(out, "Error: Unknown option '--unt'\nDid you mean '--int' or '--uint'?\n");
+}
+
+TEST(ParseResultTest, NoSuggestions) {
+    const char* argv[] = {"program", "--completely-different"};
+    slic::ArgParser<NumericOptions> parser(2, argv);
+    EXPECT_TRUE(parser.parse().suggestions().empty());
+
+    const char* dash[] = {"program", "-x"};
+    EXPECT_TRUE(parser.parse(std::span{dash}).suggestions().empty());
+
+    EXPECT_TRUE(slic::ParseResult::failure(slic::ParseError::UnknownOption, "--int").suggestions().empty());
+}
+
+TEST(ParseResultTest, CommandSuggestions) {
+    const char* argv[] = {"git", "comit"};
+    slic::ArgParser<GitOptions> parser(2, argv);
+    auto result = parser.parse();
+    EXPECT_EQ(result.argIndex, 1u);
+    auto similar = result.suggestions();
+    ASSERT_EQ(similar.size(), 1u);
+    EXPECT_EQ(similar[0], "commit");
+}
+
+TEST(ParseResultTest, PrintToStderr) {
+    testing::internal::CaptureStderr();
+    slic::ParseResult::failure(slic::ParseError::MissingValue, "--int").print();
+    EXPECT_EQ(testing::internal::GetCapturedStderr(), "Error: Missing value for option '--int'\n");
+}
+
+TEST(ParseResultTest, FileSinkWritesEveryPart) {
+    std::FILE* file = std::tmpfile();
+    ASSERT_NE(file, nullptr);
+    slic::FileSink sink{file};
+    sink.write({"a", "b", "", "c", "d", "e", "f", "g", "h", "i", "j", "k", "l", "m", "n", "o", "p", "q", "r"});
+
+    std::rewind(file);
+    char buffer[32]{};
+    size_t size = std::fread(buffer, 1, sizeof(buffer), file);
+    std::fclose(file);
+    EXPECT_EQ(std::string_view(buffer, size), "abcdefghijklmnopqr");
+}
+
+TEST(ParseResultTest, PrintIsOneBatch) {
+    struct BatchSink {
+        std::string& out;
+        int& writes;
+        void write(std::string_view text) { out += text; ++writes; }
+        void write(std::span<std::string_view const> parts) {
+            for (auto part : parts) out += part;
+            ++writes;
+        }
+    };
+
+    const char* argv[] = {"program", "--unt"};
+    slic::ArgParser<NumericOptions> parser(2, argv);
+    std::string out;
+    int writes = 0;
+    parser.parse().print(BatchSink{out, writes});
+    EXPECT_EQ(out, "Error: Unknown option '--unt'\nDid you mean '--int' or '--uint'?\n");
+    EXPECT_EQ(writes, 1);
+}
+
+TEST(ParseResultTest, FileSinkKeepsBufferedTextFirst) {
+    std::FILE* file = std::tmpfile();
+    ASSERT_NE(file, nullptr);
+    std::fputs("buffered ", file);
+    slic::FileSink{file}.write({"direct", "\n"});
+
+    std::rewind(file);
+    char buffer[32]{};
+    size_t size = std::fread(buffer, 1, sizeof(buffer), file);
+    std::fclose(file);
+    EXPECT_EQ(std::string_view(buffer, size), "buffered direct\n");
+}
+
+// ============================================================================
+// Program Name Tests
+// ============================================================================
+
+TEST(ProgramNameTest, ExtractFromPath) {
+    const char* argv[] = {"/usr/bin/myprogram"};
+    slic::ArgParser<BoolOptions> parser(1, argv);
+    EXPECT_EQ(parser.programName(), "myprogram");
+}
+
+TEST(ProgramNameTest, NoPath) {
+    const char* argv[] = {"myprogram"};
+    slic::ArgParser<BoolOptions> parser(1, argv);
+    EXPECT_EQ(parser.programName(), "myprogram");
+}
+
+// ============================================================================
+// Help Text Tests
+// ============================================================================
+
+TEST(HelpTextTest, Plain) {
+    const char* argv[] = {"/usr/bin/mixed"};
+    slic::ArgParser<MixedOptions> parser(1, argv);
+    auto text = parser.helpText(false);
+    EXPECT_EQ(text.prefix, "A mixed options test program\nUsage: ");
+    EXPECT_EQ(text.programName, "mixed");
+    EXPECT_EQ(text.body,
+        " [OPTIONS] <input> [output]\n"
+        "\n"
+        "Arguments:\n"
+        "  input: Input file\n"
+        "  output: Output file\n"
+        "\n"
+        "Options:\n"
+        "  --debug, -d: Enable debug mode\n"
+        "  --level, -l <value>: Set level\n");
+    EXPECT_EQ(text.size(), text.prefix.size() + text.programName.size() + text.body.size());
+}
+
+TEST(HelpTextTest, Ansi) {
+    const char* argv[] = {"program"};
+    slic::ArgParser<VarArgsOptions> parser(1, argv);
+    auto text = parser.helpText();
+    EXPECT_EQ(text.prefix, "\x1b[1m\x1b[4mUsage:\x1b[0m ");
+    EXPECT_EQ(text.body,
+        " <command> [...]\n"
+        "\n"
+        "\x1b[1m\x1b[4mArguments:\x1b[0m\n"
+        "  \x1b[1mcommand\x1b[0m: Command to run\n"
+        "  \x1b[1m[...]\x1b[0m: Additional arguments\n");
+}
+
+TEST(HelpTextTest, PrintHelp) {
+    const char* argv[] = {"program"};
+    slic::ArgParser<SimpleOptions> parser(1, argv);
+    auto text = parser.helpText(false);
+
+    testing::internal::CaptureStdout();
+    parser.printHelp(false);
+    std::string output = testing::internal::GetCapturedStdout();
+
+    EXPECT_EQ(output, std::string(text.prefix) + "program" + std::string(text.body));
+}
+
+TEST(HelpTextTest, PrintHelpToSink) {
+    const char* argv[] = {"program"};
+    slic::ArgParser<SimpleOptions> parser(1, argv);
+    auto text = parser.helpText(false);
+
+    std::string out;
+    parser.printHelp(StringSink{out}, false);
+    EXPECT_EQ(out, std::string(text.prefix) + "program" + std::string(text.body));
+}
+
+// ============================================================================
+// Mixed/Complex Scenarios Tests
+// ============================================================================
+
+TEST(MixedOptionsTest, Full) {
+    const char* argv[] = {"program", "-d", "--level=5", "input.txt", "output.txt"};
+    slic::ArgParser<MixedOptions> parser(5, argv);
+    auto result = parser.parse();
+    EXPECT_TRUE(result.isOk());
+    EXPECT_TRUE(parser.result().debug);
+    ASSERT_TRUE(parser.result().level.has_value());
+    EXPECT_EQ(*parser.result().level, 5);
+    EXPECT_EQ(parser.result().input, "input.txt");
+    ASSERT_TRUE(parser.result().output.has_value());
+    EXPECT_EQ(*parser.result().output, "output.txt");
+}
+
+TEST(MixedOptionsTest, Partial) {
+    const char* argv[] = {"program", "input.txt"};
+    slic::ArgParser<MixedOptions> parser(2, argv);
+    auto result = parser.parse();
+    EXPECT_TRUE(result.isOk());
+    EXPECT_FALSE(parser.result().debug);
+    EXPECT_FALSE(parser.result().level.has_value());
+    EXPECT_EQ(parser.result().input, "input.txt");
+    EXPECT_FALSE(parser.result().output.has_value());
+}
+
+TEST(MixedOptionsTest, OptionalBoolOption) {
+    const char* argv[] = {"program", "--opt-flag=true"};
+    slic::ArgParser<BoolOptions> parser(2, argv);
+    auto result = parser.parse();
+    EXPECT_TRUE(result.isOk());
+    ASSERT_TRUE(parser.result().optFlag.has_value());
+    EXPECT_TRUE(*parser.result().optFlag);
+}
+
+// ============================================================================
+// Static Compile-Time Tests
+// ============================================================================
+
+TEST(StaticTest, OptionCount) {
+    constexpr auto count = slic::ArgParser<SimpleOptions>::optionCount();
     EXPECT_EQ(count, 2u);
 }
 
-TEST(StaticTest, ArgumentCount) {
-    constexpr auto count = slic::ArgParser<SimpleOptions>::argumentCount();
-    EXPECT_EQ(count, 1u);
+TEST(StaticTest, ArgumentCount) {
+    constexpr auto count = slic::ArgParser<SimpleOptions>::argumentCount();
+    EXPECT_EQ(count, 1u);
+}
+
+TEST(StaticTest, HasVarArgs) {
+    constexpr bool hasVarArgs = slic::ArgParser<VarArgsOptions>::hasVarArgs();
+    EXPECT_TRUE(hasVarArgs);
+
+    constexpr bool noVarArgs = slic::ArgParser<SimpleOptions>::hasVarArgs();
+    EXPECT_FALSE(noVarArgs);
+}
+
+constinit ConstrainedOptions s_staticDefaults = slic::parseStatic<ConstrainedOptions>(
+    {"-t", "8", "--ratio=2.5e-1", "--format", "toml", "--level", "2", "443"});
+constinit GitOptions s_staticCommand = slic::parseStatic<GitOptions>({"-v", "add", "--force", "file.txt"});
+constinit BoolOptions s_staticEmpty = slic::parseStatic<BoolOptions>();
+
+TEST(StaticTest, ParseStatic) {
+    EXPECT_EQ(s_staticDefaults.threads, 8);
+    EXPECT_EQ(s_staticDefaults.ratio, 0.25);
+    EXPECT_EQ(s_staticDefaults.name, "default");
+    EXPECT_EQ(s_staticDefaults.format, "toml");
+    EXPECT_EQ(s_staticDefaults.level, 2);
+    EXPECT_EQ(s_staticDefaults.port, 443u);
+
+    EXPECT_TRUE(s_staticCommand.verbose);
+    ASSERT_TRUE(std::holds_alternative<AddCommand>(s_staticCommand.command));
+    EXPECT_TRUE(std::get<AddCommand>(s_staticCommand.command).force);
+    EXPECT_EQ(std::get<AddCommand>(s_staticCommand.command).path, "file.txt");
+
+    EXPECT_FALSE(s_staticEmpty.flag1);
+    EXPECT_FALSE(s_staticEmpty.optFlag.has_value());
+
+    constexpr auto modes = slic::parseStatic<EnumOptions>({"--mode", "debug", "--extra", "fast", "--extra=safe"});
+    static_assert(modes.mode == Mode::Debug && modes.extra.size() == 2);
+}
+
+// ============================================================================
+// ValueParser Direct Tests
+// ============================================================================
+
+TEST(ValueParserTest, BoolTrue) {
+    EXPECT_EQ(slic::ValueParser<bool>::parse("true"), true);
+    EXPECT_EQ(slic::ValueParser<bool>::parse("1"), true);
+    EXPECT_EQ(slic::ValueParser<bool>::parse("yes"), true);
+    EXPECT_EQ(slic::ValueParser<bool>::parse("on"), true);
+    EXPECT_EQ(slic::ValueParser<bool>::parse("y"), true);
+}
+
+TEST(ValueParserTest, BoolFalse) {
+    EXPECT_EQ(slic::ValueParser<bool>::parse("false"), false);
+    EXPECT_EQ(slic::ValueParser<bool>::parse("0"), false);
+    EXPECT_EQ(slic::ValueParser<bool>::parse("no"), false);
+    EXPECT_EQ(slic::ValueParser<bool>::parse("off"), false);
+    EXPECT_EQ(slic::ValueParser<bool>::parse("n"), false);
+}
+
+TEST(ValueParserTest, BoolInvalid) {
+    EXPECT_FALSE(slic::ValueParser<bool>::parse("invalid").has_value());
+}
+
+TEST(ValueParserTest, Int) {
+    EXPECT_EQ(slic::ValueParser<int>::parse("42"), 42);
+    EXPECT_EQ(slic::ValueParser<int>::parse("-10"), -10);
+    EXPECT_EQ(slic::ValueParser<int>::parse("0"), 0);
+}
+
+TEST(ValueParserTest, IntInvalid) {
+    EXPECT_FALSE(slic::ValueParser<int>::parse("abc").has_value());
+    EXPECT_FALSE(slic::ValueParser<int>::parse("12abc").has_value());
+    EXPECT_FALSE(slic::ValueParser<int>::parse("").has_value());
+}
+
+TEST(ValueParserTest, ConstantEvaluated) {
+    static_assert(slic::ValueParser<int>::parse("-2147483648") == INT32_MIN);
+    static_assert(!slic::ValueParser<int>::parse("2147483648"));
+    static_assert(!slic::ValueParser<unsigned>::parse("-1"));
+    static_assert(!slic::ValueParser<int>::parse("+1"));
+    static_assert(slic::ValueParser<uint64_t>::parse("18446744073709551615") == UINT64_MAX);
+    static_assert(slic::ValueParser<double>::parse("0.1") == 0.1);
+    static_assert(slic::ValueParser<double>::parse("-1.5e3") == -1500.0);
+    static_assert(slic::ValueParser<float>::parse(".5") == 0.5f);
+    static_assert(!slic::ValueParser<double>::parse("1e"));
+    static_assert(!slic::ValueParser<double>::parse("1e400"));
+    static_assert(!slic::ValueParser<float>::parse("1e39"));
+
+    // the compile-time parsers must agree with std::from_chars
+    for (std::string_view input : {"0", "-0", "42", "-7", "007", "", "-", "1x", "9223372036854775807", "9223372036854775808"}) {
+        EXPECT_EQ(slic::detail::parseInteger<long long>(input), slic::ValueParser<long long>::parse(input)) << input;
+        EXPECT_EQ(slic::detail::parseInteger<uint8_t>(input), slic::ValueParser<uint8_t>::parse(input)) << input;
+    }
+    for (std::string_view input : {"0", "1", "0.1", "3.14159", "5.", ".5", ".", "1e-5", "1E+10", "2.5e-3",
+                                   "123456789012345", "1e22", "1e308", "1e309", "inf", "-Infinity", "1.2.3", "0x10"}) {
+        EXPECT_EQ(slic::detail::parseFloat<double>(input), slic::ValueParser<double>::parse(input)) << input;
+        EXPECT_EQ(slic::detail::parseFloat<float>(input), slic::ValueParser<float>::parse(input)) << input;
+    }
+    EXPECT_TRUE(std::isnan(*slic::detail::parseFloat<double>("nan")));
+}
+
+TEST(ValueParserTest, StringView) {
+    EXPECT_EQ(slic::ValueParser<std::string_view>::parse("hello"), "hello");
+    EXPECT_EQ(slic::ValueParser<std::string_view>::parse(""), "");
+    EXPECT_EQ(slic::ValueParser<std::string_view>::parse("with spaces"), "with spaces");
+}
+
+// ============================================================================
+// Subcommand Tests
+// ============================================================================
+
+TEST(SubcommandTest, DispatchToCommand) {
+    const char* argv[] = {"git", "-v", "add", "-f", "file.txt"};
+    slic::ArgParser<GitOptions> parser(5, argv);
+    ASSERT_TRUE(parser.parse().isOk());
+
+    auto const& opts = parser.result();
+    EXPECT_TRUE(opts.verbose);
+    ASSERT_EQ(opts.command.index(), 1u);
+    EXPECT_TRUE(std::get<AddCommand>(opts.command).force);
+    EXPECT_EQ(std::get<AddCommand>(opts.command).path, "file.txt");
+}
+
+TEST(SubcommandTest, OptionsAfterCommandBelongToIt) {
+    const char* argv[] = {"git", "commit", "--amend", "-m", "msg"};
+    slic::ArgParser<GitOptions> parser(5, argv);
+    ASSERT_TRUE(parser.parse().isOk());
+
+    auto const& opts = parser.result();
+    EXPECT_FALSE(opts.verbose);
+    auto const& commit = std::get<CommitCommand>(opts.command);
+    EXPECT_TRUE(commit.amend);
+    EXPECT_EQ(commit.message, "msg");
+}
+
+TEST(SubcommandTest, NoCommand) {
+    const char* argv[] = {"git", "-v"};
+    slic::ArgParser<GitOptions> parser(2, argv);
+    ASSERT_TRUE(parser.parse().isOk());
+    EXPECT_TRUE(std::holds_alternative<std::monostate>(parser.result().command));
+}
+
+TEST(SubcommandTest, UnknownCommand) {
+    const char* argv[] = {"git", "push"};
+    slic::ArgParser<GitOptions> parser(2, argv);
+    auto result = parser.parse();
+    EXPECT_EQ(result.error, slic::ParseError::UnknownCommand);
+    EXPECT_EQ(result.context, "push");
+}
+
+TEST(SubcommandTest, CommandErrorPropagates) {
+    const char* argv[] = {"git", "add", "--verbose"};
+    slic::ArgParser<GitOptions> parser(3, argv);
+    auto result = parser.parse();
+    EXPECT_EQ(result.error, slic::ParseError::UnknownOption);
+    EXPECT_EQ(result.context, "--verbose");
+    EXPECT_TRUE(std::holds_alternative<std::monostate>(parser.result().command));
+}
+
+TEST(SubcommandTest, CommandEnvironment) {
+    const char* argv[] = {"git", "commit"};
+    const char* envp[] = {"GIT_MESSAGE=from env", nullptr};
+    slic::ArgParser<GitOptions> parser(2, argv);
+    ASSERT_TRUE(parser.parseWithEnv(envp).isOk());
+    EXPECT_EQ(std::get<CommitCommand>(parser.result().command).message, "from env");
+}
+
+TEST(SubcommandTest, HelpText) {
+    const char* argv[] = {"git"};
+    slic::ArgParser<GitOptions> parser(1, argv);
+    EXPECT_EQ(parser.helpText(false).body,
+        " [OPTIONS] <COMMAND> [...]\n"
+        "\n"
+        "Commands:\n"
+        "  add: Add a file\n"
+        "  commit\n"
+        "\n"
+        "Options:\n"
+        "  -v, --verbose: Verbose output\n");
+}
+
+// ============================================================================
+// Completion Tests
+// ============================================================================
+
+static std::string complete(std::vector<std::string_view> const& words) {
+    std::string out;
+    slic::ArgParser<CompletionOptions>::writeCompletions(slic::ArgSpan{std::span(words)}, StringSink{out});
+    return out;
+}
+
+TEST(CompletionTest, OptionNames) {
+    EXPECT_EQ(complete({"--"}), "--jobs\n--mode\n--verbose\n");
+    EXPECT_EQ(complete({"--v"}), "--verbose\n");
+    EXPECT_EQ(complete({"-"}), "--jobs\n--mode\n--verbose\n-j\n-m\n-v\n");
+    EXPECT_EQ(complete({"--x"}), "");
+}
+
+TEST(CompletionTest, Commands) {
+    EXPECT_EQ(complete({""}), "add\ncommit\n");
+    EXPECT_EQ(complete({"-v", "c"}), "commit\n");
+    EXPECT_EQ(complete({}), "add\ncommit\n");
+}
+
+TEST(CompletionTest, EnumValues) {
+    EXPECT_EQ(complete({"--mode", ""}), "fast\nsafe\ndebug\n");
+    EXPECT_EQ(complete({"-m", "d"}), "debug\n");
+    EXPECT_EQ(complete({"--mode=s"}), "--mode=safe\n");
+    EXPECT_EQ(complete({"--mode", "=", "f"}), "fast\n");
+    EXPECT_EQ(complete({"--jobs", ""}), "");
+    EXPECT_EQ(complete({"--mode", "fast", ""}), "add\ncommit\n");
 }
 
-TEST(StaticTest, HasVarArgs) {
-    constexpr bool hasVarArgs = slic::ArgParser<VarArgsOptions>::hasVarArgs();
-    EXPECT_TRUE(hasVarArgs);
+TEST(CompletionTest, Subcommand) {
+    EXPECT_EQ(complete({"-m", "fast", "add", "--"}), "--force\n");
+    EXPECT_EQ(complete({"commit", "--a"}), "--amend\n");
+    EXPECT_EQ(complete({"-v", "commit", "-m", "msg", "-"}), "--amend\n--message\n-m\n");
+}
 
-    constexpr bool noVarArgs = slic::ArgParser<SimpleOptions>::hasVarArgs();
-    EXPECT_FALSE(noVarArgs);
+TEST(CompletionTest, AnsweredByParse) {
+    const char* argv[] = {"tool", "--complete", "--verb"};
+    slic::ArgParser<CompletionOptions> parser(3, argv);
+    testing::internal::CaptureStdout();
+    auto result = parser.parse();
+    EXPECT_EQ(testing::internal::GetCapturedStdout(), "--verbose\n");
+    EXPECT_EQ(result.error, slic::ParseError::CompletionWritten);
+    EXPECT_TRUE(result.handled());
+}
+
+TEST(CompletionTest, HandledResultPrintsNothing) {
+    const char* argv[] = {"tool", "--complete", "--verb"};
+    slic::ArgParser<CompletionOptions> parser(3, argv);
+    testing::internal::CaptureStdout();
+    auto result = parser.parse();
+    (void) testing::internal::GetCapturedStdout();
+
+    // the usual error path of a main() must exit successfully and stay quiet
+    testing::internal::CaptureStderr();
+    int exitCode = 0;
+    if (!result) {
+        result.print();
+        exitCode = result.handled() ? 0 : 1;
+    }
+    EXPECT_EQ(testing::internal::GetCapturedStderr(), "");
+    EXPECT_EQ(exitCode, 0);
+
+    std::string out;
+    result.print(StringSink{out});
+    EXPECT_EQ(out, "");
+
+    const char* bad[] = {"tool", "--bogus"};
+    slic::ArgParser<CompletionOptions> badParser(2, bad);
+    auto failure = badParser.parse();
+    EXPECT_FALSE(failure.handled());
+    failure.print(StringSink{out});
+    EXPECT_EQ(out, "Error: Unknown option '--bogus'\n");
+}
+
+TEST(CompletionTest, OnlyAsFirstArgument) {
+    const char* argv[] = {"tool", "-v", "--complete"};
+    slic::ArgParser<CompletionOptions> parser(3, argv);
+    EXPECT_EQ(parser.parse().error, slic::ParseError::UnknownOption);
+
+    const char* plain[] = {"tool", "--complete", "x"};
+    slic::ArgParser<GitOptions> disabled(3, plain);
+    EXPECT_EQ(disabled.parse().error, slic::ParseError::UnknownOption);
+}
+
+TEST(CompletionTest, Scripts) {
+    const char* argv[] = {"/usr/bin/my-tool"};
+    slic::ArgParser<CompletionOptions> parser(1, argv);
+    std::string bash;
+    parser.writeCompletionScript(slic::Shell::Bash, StringSink{bash});
+    EXPECT_NE(bash.find("my-tool --complete \"${COMP_WORDS[@]:1:COMP_CWORD}\""), std::string::npos);
+    EXPECT_NE(bash.find("complete -o default -F _slic_complete_my_tool my-tool\n"), std::string::npos);
+
+    std::string zsh;
+    parser.writeCompletionScript(slic::Shell::Zsh, StringSink{zsh});
+    EXPECT_TRUE(zsh.starts_with("#compdef my-tool\n"));
+
+    std::string fish;
+    parser.writeCompletionScript(slic::Shell::Fish, StringSink{fish});
+    EXPECT_NE(fish.find("complete -c my-tool -a '(_slic_complete_my_tool)'"), std::string::npos);
+}
+
+TEST(CompletionTest, ScriptRequest) {
+    const char* argv[] = {"tool", "--completions", "fish"};
+    slic::ArgParser<CompletionOptions> parser(3, argv);
+    testing::internal::CaptureStdout();
+    auto result = parser.parse();
+    EXPECT_NE(testing::internal::GetCapturedStdout().find("function _slic_complete_tool"), std::string::npos);
+    EXPECT_EQ(result.error, slic::ParseError::CompletionWritten);
+
+    const char* bad[] = {"tool", "--completions", "tcsh"};
+    slic::ArgParser<CompletionOptions> badParser(3, bad);
+    auto badResult = badParser.parse();
+    EXPECT_EQ(badResult.error, slic::ParseError::InvalidValue);
+    EXPECT_EQ(badResult.argIndex, 1u);
 }
 
 // ============================================================================
-// ValueParser Direct Tests
+// Reuse Tests
 // ============================================================================
 
-TEST(ValueParserTest, BoolTrue) {
-    EXPECT_EQ(slic::ValueParser<bool>::parse("true"), true);
-    EXPECT_EQ(slic::ValueParser<bool>::parse("1"), true);
-    EXPECT_EQ(slic::ValueParser<bool>::parse("yes"), true);
-    EXPECT_EQ(slic::ValueParser<bool>::parse("on"), true);
-    EXPECT_EQ(slic::ValueParser<bool>::parse("y"), true);
+TEST(ReuseTest, ResetsToDefaults) {
+    const char* first[] = {"program", "--int", "42", "-d", "1.5", "--long", "9"};
+    const char* second[] = {"other", "--int", "7"};
+
+    slic::ArgParser<NumericOptions> parser;
+    ASSERT_TRUE(parser.parse(first).isOk());
+    EXPECT_EQ(parser.result().intVal, 42);
+    EXPECT_EQ(parser.programName(), "program");
+
+    ASSERT_TRUE(parser.parse(second).isOk());
+    EXPECT_EQ(parser.result().intVal, 7);
+    EXPECT_EQ(parser.result().doubleVal, NumericOptions{}.doubleVal);
+    EXPECT_EQ(parser.result().longVal, NumericOptions{}.longVal);
+    EXPECT_EQ(parser.programName(), "other");
 }
 
-TEST(ValueParserTest, BoolFalse) {
-    EXPECT_EQ(slic::ValueParser<bool>::parse("false"), false);
-    EXPECT_EQ(slic::ValueParser<bool>::parse("0"), false);
-    EXPECT_EQ(slic::ValueParser<bool>::parse("no"), false);
-    EXPECT_EQ(slic::ValueParser<bool>::parse("off"), false);
-    EXPECT_EQ(slic::ValueParser<bool>::parse("n"), false);
+TEST(ReuseTest, ResetsPositionalsAndRepeats) {
+    const char* first[] = {"program", "-I", "a", "-I", "b", "-I", "c"};
+    const char* second[] = {"program", "-I", "d"};
+
+    slic::ArgParser<CollectOptions> parser;
+    ASSERT_TRUE(parser.parse(first).isOk());
+    ASSERT_TRUE(parser.parse(second).isOk());
+    ASSERT_EQ(parser.result().includes.size(), 1u);
+    EXPECT_EQ(parser.result().includes[0], "d");
 }
 
-TEST(ValueParserTest, BoolInvalid) {
-    EXPECT_FALSE(slic::ValueParser<bool>::parse("invalid").has_value());
+TEST(ReuseTest, ErrorDoesNotLeak) {
+    const char* bad[] = {"program", "--unknown"};
+    const char* good[] = {"program", "input.txt"};
+
+    slic::ArgParser<MixedOptions> parser;
+    EXPECT_EQ(parser.parse(bad).error, slic::ParseError::UnknownOption);
+    ASSERT_TRUE(parser.parse(good).isOk());
+    EXPECT_EQ(parser.result().input, "input.txt");
 }
 
-TEST(ValueParserTest, Int) {
-    EXPECT_EQ(slic::ValueParser<int>::parse("42"), 42);
-    EXPECT_EQ(slic::ValueParser<int>::parse("-10"), -10);
-    EXPECT_EQ(slic::ValueParser<int>::parse("0"), 0);
+TEST(ReuseTest, ParseBatch) {
+    const char* first[] = {"program", "--int", "1"};
+    const char* second[] = {"program", "--int", "oops"};
+    const char* third[] = {"program", "--int", "3", "--long", "5"};
+    std::span<char const* const> inputs[] = {first, second, third};
+
+    NumericOptions outputs[3];
+    slic::ParseResult results[3];
+    slic::ArgParser<NumericOptions> parser;
+    EXPECT_EQ(parser.parseBatch(inputs, outputs, results), 2u);
+
+    EXPECT_TRUE(results[0].isOk());
+    EXPECT_EQ(outputs[0].intVal, 1);
+    EXPECT_EQ(results[1].error, slic::ParseError::InvalidValue);
+    EXPECT_TRUE(results[2].isOk());
+    EXPECT_EQ(outputs[2].intVal, 3);
+    EXPECT_EQ(outputs[2].longVal, 5);
 }
 
-TEST(ValueParserTest, IntInvalid) {
-    EXPECT_FALSE(slic::ValueParser<int>::parse("abc").has_value());
-    EXPECT_FALSE(slic::ValueParser<int>::parse("12abc").has_value());
-    EXPECT_FALSE(slic::ValueParser<int>::parse("").has_value());
+// ============================================================================
+// Required Option Tests
+// ============================================================================
+
+TEST(RequiredOptionTest, AllGiven) {
+    const char* argv[] = {"program", "--replicas", "3", "-c", "prod", "input.txt"};
+    slic::ArgParser<RequiredOptions> parser(6, argv);
+    ASSERT_TRUE(parser.parse().isOk());
+    EXPECT_EQ(parser.result().cluster, "prod");
+    EXPECT_EQ(parser.result().replicas, 3);
 }
 
-TEST(ValueParserTest, StringView) {
-    EXPECT_EQ(slic::ValueParser<std::string_view>::parse("hello"), "hello");
-    EXPECT_EQ(slic::ValueParser<std::string_view>::parse(""), "");
-    EXPECT_EQ(slic::ValueParser<std::string_view>::parse("with spaces"), "with spaces");
+TEST(RequiredOptionTest, FirstMissingIsReported) {
+    const char* argv[] = {"program", "input.txt"};
+    slic::ArgParser<RequiredOptions> parser(2, argv);
+    auto result = parser.parse();
+    EXPECT_EQ(result.error, slic::ParseError::MissingRequiredOption);
+    EXPECT_EQ(result.context, "--cluster");
+}
+
+TEST(RequiredOptionTest, SecondMissing) {
+    const char* argv[] = {"program", "--cluster=prod", "input.txt"};
+    slic::ArgParser<RequiredOptions> parser(3, argv);
+    auto result = parser.parse();
+    EXPECT_EQ(result.error, slic::ParseError::MissingRequiredOption);
+    EXPECT_EQ(result.context, "--replicas");
+}
+
+TEST(RequiredOptionTest, SatisfiedByEnvironment) {
+    const char* argv[] = {"program", "-c", "prod", "input.txt"};
+    const char* envp[] = {"REPLICAS=5", nullptr};
+    slic::ArgParser<RequiredOptions> parser(4, argv);
+    ASSERT_TRUE(parser.parseWithEnv(envp).isOk());
+    EXPECT_EQ(parser.result().replicas, 5);
+}
+
+TEST(RequiredOptionTest, PositionalsStillRequired) {
+    const char* argv[] = {"program", "-c", "prod", "--replicas", "2"};
+    slic::ArgParser<RequiredOptions> parser(5, argv);
+    auto result = parser.parse();
+    EXPECT_EQ(result.error, slic::ParseError::MissingRequiredArg);
+    EXPECT_EQ(result.context, "input");
+}
+
+TEST(RequiredOptionTest, ShownInHelp) {
+    const char* argv[] = {"program"};
+    slic::ArgParser<RequiredOptions> parser(1, argv);
+    auto body = parser.helpText(false).body;
+    EXPECT_NE(body.find("  -c, --cluster <value>: Target cluster [required]\n"), std::string_view::npos);
+    EXPECT_NE(body.find("  --replicas <value> [env: REPLICAS] [required]\n"), std::string_view::npos);
+}
+
+// ============================================================================
+// Presence Tests
+// ============================================================================
+
+TEST(PresenceTest, OptionsAndPositionals) {
+    const char* argv[] = {"program", "-c", "0", "alice"};
+    slic::ArgParser<SimpleOptions> parser(4, argv);
+    ASSERT_TRUE(parser.parse().isOk());
+    EXPECT_FALSE(parser.isSet<&SimpleOptions::verbose>());
+    EXPECT_TRUE(parser.isSet<&SimpleOptions::count>());
+    EXPECT_TRUE(parser.isSet<&SimpleOptions::name>());
+}
+
+TEST(PresenceTest, ClearedByNextParse) {
+    const char* first[] = {"program", "-v", "-c", "3", "a"};
+    const char* second[] = {"program", "b"};
+    slic::ArgParser<SimpleOptions> parser;
+    ASSERT_TRUE(parser.parse(std::span{first}).isOk());
+    EXPECT_TRUE(parser.isSet<&SimpleOptions::verbose>());
+    ASSERT_TRUE(parser.parse(std::span{second}).isOk());
+    EXPECT_FALSE(parser.isSet<&SimpleOptions::verbose>());
+    EXPECT_FALSE(parser.isSet<&SimpleOptions::count>());
+    EXPECT_TRUE(parser.isSet<&SimpleOptions::name>());
+}
+
+TEST(PresenceTest, EnvironmentCounts) {
+    const char* argv[] = {"program", "--mode", "safe"};
+    const char* envp[] = {"APP_THREADS=1", nullptr};
+    slic::ArgParser<EnvOptions> parser(3, argv);
+    ASSERT_TRUE(parser.parseWithEnv(envp).isOk());
+    EXPECT_TRUE(parser.isSet<&EnvOptions::threads>()); // same value as the default
+    EXPECT_TRUE(parser.isSet<&EnvOptions::mode>());
+    EXPECT_FALSE(parser.isSet<&EnvOptions::verbose>());
+    EXPECT_FALSE(parser.isSet<&EnvOptions::cluster>());
+}
+
+TEST(PresenceTest, VarArgs) {
+    const char* withRest[] = {"program", "run", "x"};
+    const char* withoutRest[] = {"program", "run", "--"};
+    slic::ArgParser<VarArgsOptions> parser;
+    ASSERT_TRUE(parser.parse(std::span{withRest}).isOk());
+    EXPECT_TRUE(parser.isSet<&VarArgsOptions::args>());
+    ASSERT_TRUE(parser.parse(std::span{withoutRest}).isOk());
+    EXPECT_TRUE(parser.isSet<&VarArgsOptions::command>());
+    EXPECT_FALSE(parser.isSet<&VarArgsOptions::args>());
+}
+
+TEST(PresenceTest, CompileTime) {
+    constexpr bool set = [] {
+        const char* argv[] = {"program", "-v", "bob"};
+        slic::ArgParser<SimpleOptions> parser(3, argv);
+        (void) parser.parse();
+        return parser.isSet<&SimpleOptions::verbose>() && !parser.isSet<&SimpleOptions::count>();
+    }();
+    static_assert(set);
+    SUCCEED();
+}
+
+// ============================================================================
+// Enum Tests
+// ============================================================================
+
+TEST(EnumTest, ParseNames) {
+    const char* argv[] = {"program", "--mode", "debug", "--fallback=fast", "--extra", "safe", "--extra", "fast"};
+    slic::ArgParser<EnumOptions> parser(8, argv);
+    ASSERT_TRUE(parser.parse().isOk());
+    EXPECT_EQ(parser.result().mode, Mode::Debug);
+    EXPECT_EQ(parser.result().fallback, Mode::Fast);
+    ASSERT_EQ(parser.result().extra.size(), 2u);
+    EXPECT_EQ(parser.result().extra[0], Mode::Safe);
+    EXPECT_EQ(parser.result().extra[1], Mode::Fast);
+}
+
+TEST(EnumTest, Defaults) {
+    const char* argv[] = {"program"};
+    slic::ArgParser<EnumOptions> parser(1, argv);
+    ASSERT_TRUE(parser.parse().isOk());
+    EXPECT_EQ(parser.result().mode, Mode::Safe);
+    EXPECT_FALSE(parser.result().fallback.has_value());
+}
+
+TEST(EnumTest, UnknownName) {
+    const char* argv[] = {"program", "-m", "Fast"};
+    slic::ArgParser<EnumOptions> parser(3, argv);
+    auto result = parser.parse();
+    EXPECT_EQ(result.error, slic::ParseError::InvalidValue);
+}
+
+TEST(EnumTest, ValueParser) {
+    static_assert(slic::ValueParser<Mode>::parse("safe") == Mode::Safe);
+    EXPECT_EQ(slic::ValueParser<Mode>::parse("debug"), Mode::Debug);
+    EXPECT_FALSE(slic::ValueParser<Mode>::parse("debu").has_value());
+    EXPECT_FALSE(slic::ValueParser<Mode>::parse("").has_value());
+}
+
+TEST(EnumTest, HelpListsNames) {
+    const char* argv[] = {"program"};
+    slic::ArgParser<EnumOptions> parser(1, argv);
+    EXPECT_EQ(parser.helpText(false).body,
+        " [OPTIONS]\n"
+        "\n"
+        "Options:\n"
+        "  -m, --mode <fast|safe|debug>: Execution mode\n"
+        "  --fallback <fast|safe|debug>\n"
+        "  --extra <fast|safe|debug>...\n");
+}
+
+// ============================================================================
+// Constraint Tests
+// ============================================================================
+
+TEST(ConstraintTest, AcceptsValuesInside) {
+    const char* argv[] = {"program", "-t", "256", "--ratio=0.25", "--name", "x", "--format", "yaml", "--level", "3", "8080"};
+    slic::ArgParser<ConstrainedOptions> parser(11, argv);
+    ASSERT_TRUE(parser.parse().isOk());
+    EXPECT_EQ(parser.result().threads, 256);
+    EXPECT_DOUBLE_EQ(parser.result().ratio, 0.25);
+    EXPECT_EQ(parser.result().name, "x");
+    EXPECT_EQ(parser.result().format, "yaml");
+    EXPECT_EQ(parser.result().level, 3);
+    EXPECT_EQ(parser.result().port, 8080u);
+}
+
+TEST(ConstraintTest, RejectsValuesOutside) {
+    auto parse = [](std::vector<char const*> argv) {
+        slic::ArgParser<ConstrainedOptions> parser(static_cast<int>(argv.size()), argv.data());
+        return parser.parse();
+    };
+
+    auto range = parse({"program", "--threads", "0"});
+    EXPECT_EQ(range.error, slic::ParseError::InvalidValue);
+    EXPECT_EQ(range.context, "--threads [range: 1..256]");
+    EXPECT_EQ(range.value, "0");
+    EXPECT_EQ(range.argIndex, 2u);
+
+    std::string message;
+    range.print(StringSink{message});
+    EXPECT_EQ(message, "Error: Invalid value '0' for '--threads [range: 1..256]'\n");
+
+    EXPECT_EQ(parse({"program", "--threads=257"}).value, "257");
+    EXPECT_EQ(parse({"program", "--ratio", "0.2"}).context, "--ratio [min: 0.25]");
+    EXPECT_EQ(parse({"program", "--name="}).context, "--name [non-empty]");
+    EXPECT_EQ(parse({"program", "--format", "xml"}).context, "--format [one of: json, yaml, toml]");
+    EXPECT_EQ(parse({"program", "--level", "4"}).context, "--level [one of: 1, 2, 3]");
+    EXPECT_EQ(parse({"program", "65536"}).context, "port [max: 65535]");
+    EXPECT_EQ(parse({"program", "65536"}).value, "65536");
+    EXPECT_EQ(parse({"program", "--name="}).value.data() != nullptr, true);
+
+    // values that don't convert keep the option as their context
+    EXPECT_EQ(parse({"program", "--threads", "many"}).context, "--threads");
+    EXPECT_EQ(parse({"program", "--threads", "many"}).value.data(), nullptr);
+}
+
+TEST(ConstraintTest, CheckedForEnvironment) {
+    const char* argv[] = {"program"};
+    const char* envp[] = {"APP_THREADS=1000", nullptr};
+    slic::ArgParser<ConstrainedOptions> parser(1, argv);
+    auto result = parser.parseWithEnv(envp);
+    EXPECT_EQ(result.error, slic::ParseError::InvalidValue);
+    EXPECT_EQ(result.context, "--threads [range: 1..256]");
+}
+
+TEST(ConstraintTest, ShownInHelp) {
+    const char* argv[] = {"program"};
+    slic::ArgParser<ConstrainedOptions> parser(1, argv);
+    auto body = parser.helpText(false).body;
+    EXPECT_NE(body.find("  port:  [max: 65535]\n"), std::string_view::npos);
+    EXPECT_NE(body.find("--threads <value>: Worker threads [env: APP_THREADS] [range: 1..256]\n"), std::string_view::npos);
+    EXPECT_NE(body.find("  --format <value> [one of: json, yaml, toml]\n"), std::string_view::npos);
+}
+
+struct WideConstraints {
+    double limit = 0;
+    float scale = 1;
+    int level = 0;
+
+    static constexpr auto Options = std::make_tuple(
+        slic::Option{"--limit", &WideConstraints::limit}.max(1e20),
+        slic::Option{"--scale", &WideConstraints::scale}.range(1e-6f, 3.4e38f),
+        slic::Option{"--level", &WideConstraints::level}.oneOf({1, 2, 3, 4, 5, 6, 7, 8})
+    );
+};
+
+TEST(ConstraintTest, ExtremeLimits) {
+    const char* argv[] = {"program", "--limit", "1e21"};
+    slic::ArgParser<WideConstraints> parser(3, argv);
+    auto result = parser.parse();
+    EXPECT_EQ(result.context, "--limit [max: 1e20]");
+    EXPECT_EQ(result.value, "1e21");
+
+    auto body = parser.helpText(false).body;
+    EXPECT_NE(body.find("--scale <value> [range: 1e-6..3.4e38]"), std::string_view::npos);
+    EXPECT_NE(body.find("[one of: 1, 2, 3, 4, 5, 6, 7, 8]"), std::string_view::npos);
+
+    // a run-time list longer than MaxChoices keeps the first ones instead of overflowing
+    auto level = slic::Option{"--level", &WideConstraints::level};
+    std::initializer_list<int> tooMany = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+    EXPECT_EQ(level.oneOf(tooMany).constraints().choiceCount, 8u);
+}
+
+TEST(ConstraintTest, CompileTime) {
+    constexpr auto const& threads = std::get<0>(ConstrainedOptions::Options);
+    static_assert(threads.constraints().accepts(1) && !threads.constraints().accepts(0));
+    static_assert(!std::get<5>(ConstrainedOptions::Options).constraints().accepts(70000u));
+
+    // entries without constraints, and types that can't have them, skip the check entirely
+    static_assert(!std::get<1>(SimpleOptions::Options).constraints().any());
+    static_assert(std::is_empty_v<std::remove_cvref_t<decltype(std::get<0>(BoolOptions::Options).constraints())>>);
+    SUCCEED();
+}
+
+// ============================================================================
+// Token Classification Tests
+// ============================================================================
+
+TEST(TokenClassificationTest, ValueAcrossChunks) {
+    // the value of --int is the first token of the second chunk
+    const char* argv[] = {"program", "-f", "1", "-f", "2", "-f", "3", "-u", "4", "--int", "42", "--long=7"};
+    slic::ArgParser<NumericOptions> parser(12, argv);
+    ASSERT_TRUE(parser.parse().isOk());
+    EXPECT_EQ(parser.result().intVal, 42);
+    EXPECT_EQ(parser.result().longVal, 7);
+    EXPECT_EQ(parser.result().uintVal, 4u);
+}
+
+TEST(TokenClassificationTest, SeparatorInLaterChunk) {
+    const char* argv[] = {"program", "cmd", "a", "b", "c", "d", "e", "f", "g", "h", "--", "-x", "--y=z"};
+    slic::ArgParser<VarArgsOptions> parser(13, argv);
+    ASSERT_TRUE(parser.parse().isOk());
+    EXPECT_EQ(parser.result().command, "cmd");
+    ASSERT_EQ(parser.result().args.size(), 11u);
+    EXPECT_EQ(parser.result().args[8], "--");
+    EXPECT_EQ(parser.result().args[10], "--y=z");
+}
+
+TEST(TokenClassificationTest, LoneDashIsUnknownOption) {
+    const char* argv[] = {"program", "-"};
+    slic::ArgParser<BoolOptions> parser(2, argv);
+    auto result = parser.parse();
+    EXPECT_EQ(result.error, slic::ParseError::UnknownOption);
+    EXPECT_EQ(result.context, "-");
+}
+
+TEST(TokenClassificationTest, InlineValueFromViews) {
+    std::string_view args[] = {"program", "--int=5", "-d=2.5", "--long"};
+    slic::ArgParser<NumericOptions> parser;
+    auto result = parser.parse(slic::ArgSpan{args});
+    EXPECT_EQ(result.error, slic::ParseError::MissingValue);
+    EXPECT_EQ(result.context, "--long");
+    EXPECT_EQ(parser.result().intVal, 5);
+    EXPECT_DOUBLE_EQ(parser.result().doubleVal, 2.5);
+}
+
+// ============================================================================
+// Tokenizer Tests
+// ============================================================================
+
+TEST(TokenizerTest, PlainTokensAreViews) {
+    std::string_view tokens[4];
+    char scratch[8];
+    slic::Tokenizer tokenizer(tokens, scratch);
+
+    std::string_view line = "  program\t--count 3\n";
+    ASSERT_TRUE(tokenizer.tokenize(line));
+    auto args = tokenizer.tokens();
+    ASSERT_EQ(args.size(), 3u);
+    EXPECT_EQ(args[0], "program");
+    EXPECT_EQ(args[1], "--count");
+    EXPECT_EQ(args[2], "3");
+    EXPECT_EQ(args[1].data(), line.data() + 10);
+}
+
+TEST(TokenizerTest, QuotesAndEscapes) {
+    std::string_view tokens[8];
+    char scratch[64];
+    slic::Tokenizer tokenizer(tokens, scratch);
+
+    std::string_view line = R"("with spaces" 'single \ quoted' escaped\ space "" mi"x"ed "a\"b")";
+    ASSERT_TRUE(tokenizer.tokenize(line));
+    auto args = tokenizer.tokens();
+    ASSERT_EQ(args.size(), 6u);
+    EXPECT_EQ(args[0], "with spaces");
+    EXPECT_EQ(args[0].data(), line.data() + 1);
+    EXPECT_EQ(args[1], "single \\ quoted");
+    EXPECT_EQ(args[2], "escaped space");
+    EXPECT_EQ(args[3], "");
+    EXPECT_EQ(args[4], "mixed");
+    EXPECT_EQ(args[5], "a\"b");
+}
+
+TEST(TokenizerTest, LongTokens) {
+    std::string first(40, 'a');
+    std::string second = std::string(20, 'b') + "\x01" + std::string(20, 'c');
+    std::string third = std::string(17, 'd') + "\\ " + std::string(30, 'e');
+    std::string line = first + "  " + second + '\0' + third;
+
+    std::string_view tokens[4];
+    char scratch[64];
+    slic::Tokenizer tokenizer(tokens, scratch);
+    ASSERT_TRUE(tokenizer.tokenize(line));
+    auto args = tokenizer.tokens();
+    ASSERT_EQ(args.size(), 3u);
+    EXPECT_EQ(args[0], first);
+    EXPECT_EQ(args[1], second);
+    EXPECT_EQ(args[2], std::string(17, 'd') + " " + std::string(30, 'e'));
+}
+
+TEST(TokenizerTest, BufferTooSmall) {
+    std::string_view tokens[2];
+    char scratch[4];
+    slic::Tokenizer tokenizer(tokens, scratch);
+    EXPECT_FALSE(tokenizer.tokenize("a b c"));
+    EXPECT_TRUE(tokenizer.tokenize("a b"));
+}
+
+TEST(TokenizerTest, ScratchTooSmall) {
+    // one token with plenty of token slots, so only the 12 unescaped bytes can fail to fit
+    std::string_view tokens[8];
+    char small[4];
+    slic::Tokenizer tight(tokens, small);
+    EXPECT_FALSE(tight.tokenize("a\\ long\\ token"));
+
+    char large[16];
+    slic::Tokenizer roomy(tokens, large);
+    ASSERT_TRUE(roomy.tokenize("a\\ long\\ token"));
+    ASSERT_EQ(roomy.tokens().size(), 1u);
+    EXPECT_EQ(roomy.tokens()[0], "a long token");
+}
+
+TEST(TokenizerTest, ParseString) {
+    std::string_view tokens[8];
+    char scratch[64];
+    slic::Tokenizer tokenizer(tokens, scratch);
+
+    slic::ArgParser<VarArgsOptions> parser;
+    ASSERT_TRUE(parser.parseString("tool run -- 'first arg' second", tokenizer).isOk());
+    EXPECT_EQ(parser.programName(), "tool");
+    EXPECT_EQ(parser.result().command, "run");
+    ASSERT_EQ(parser.result().args.size(), 2u);
+    EXPECT_EQ(parser.result().args[0], "first arg");
+    EXPECT_EQ(parser.result().args[1], "second");
+}
+
+TEST(TokenizerTest, ParseStringOverflow) {
+    std::string_view tokens[2];
+    char scratch[8];
+    slic::Tokenizer tokenizer(tokens, scratch);
+
+    slic::ArgParser<VarArgsOptions> parser;
+    EXPECT_EQ(parser.parseString("tool run extra", tokenizer).error, slic::ParseError::TooManyTokens);
+}
+
+// ============================================================================
+// Parse Observer Tests
+// ============================================================================
+
+TEST(ObserverTest, RecordsEvents) {
+    const char* argv[] = {"program", "-v", "--count=3", "bob"};
+    slic::ArgParser<SimpleOptions, RecordingObserver> parser(4, argv);
+    ASSERT_TRUE(parser.parse().isOk());
+    EXPECT_EQ(parser.observer().events,
+        "T1:-v O1:-v T2:--count=3 O2:-c V2:3 T3:bob V3:bob ");
+    EXPECT_EQ(parser.result().count, 3);
+}
+
+TEST(ObserverTest, RecordsErrors) {
+    const char* argv[] = {"program", "--count", "x"};
+    slic::ArgParser<SimpleOptions, RecordingObserver> parser(3, argv);
+    EXPECT_FALSE(parser.parse().isOk());
+    EXPECT_EQ(parser.observer().events, "T1:--count O1:-c V2:x! E2:--count ");
+}
+
+TEST(ObserverTest, EnvironmentHasNoArgIndex) {
+    const char* argv[] = {"program"};
+    const char* envp[] = {"APP_THREADS=bad", nullptr};
+    slic::ArgParser<EnvOptions, RecordingObserver> parser(1, argv);
+    EXPECT_FALSE(parser.parseWithEnv(envp).isOk());
+    auto npos = std::to_string(SIZE_MAX);
+    EXPECT_NE(parser.observer().events.find("V" + npos + ":bad!"), std::string::npos);
+    EXPECT_NE(parser.observer().events.find("E" + npos), std::string::npos);
+}
+
+TEST(ObserverTest, FollowsSubcommands) {
+    const char* argv[] = {"git", "-v", "add", "file.txt"};
+    slic::ArgParser<GitOptions, RecordingObserver> parser(4, argv);
+    ASSERT_TRUE(parser.parse().isOk());
+    EXPECT_EQ(parser.observer().events, "T1:-v O1:--verbose T2:add T3:file.txt V3:file.txt ");
+}
+
+TEST(ObserverTest, CountingObserver) {
+    const char* argv[] = {"program", "-v", "-c", "1", "--count", "2", "bob"};
+    slic::ArgParser<SimpleOptions, slic::CountingObserver<SimpleOptions>> parser(7, argv);
+    ASSERT_TRUE(parser.parse().isOk());
+    auto const& counts = parser.observer();
+    EXPECT_EQ(counts.tokens, 4u);
+    EXPECT_EQ(counts.values, 3u);
+    EXPECT_EQ(counts.errors, 0u);
+    EXPECT_EQ(counts.hitsFor("--count"), 2u);
+    EXPECT_EQ(counts.hitsFor("-v"), 1u);
+    EXPECT_EQ(counts.hitsFor("--unknown"), 0u);
+
+    parser.observer().reset();
+    EXPECT_EQ(parser.observer().tokens, 0u);
+}
+
+// ============================================================================
+// Abbreviation Tests
+// ============================================================================
+
+TEST(AbbreviationTest, UniquePrefix) {
+    const char* argv[] = {"program", "--verb", "--cou=3", "--col", "red"};
+    slic::ArgParser<AbbreviatedOptions> parser(5, argv);
+    ASSERT_TRUE(parser.parse().isOk());
+    EXPECT_TRUE(parser.result().verbose);
+    EXPECT_FALSE(parser.result().version);
+    EXPECT_EQ(parser.result().count, 3);
+    EXPECT_EQ(parser.result().color, "red");
+}
+
+TEST(AbbreviationTest, ExactMatchWins) {
+    const char* argv[] = {"program", "--version", "--colour=blue"};
+    slic::ArgParser<AbbreviatedOptions> parser(3, argv);
+    ASSERT_TRUE(parser.parse().isOk());
+    EXPECT_TRUE(parser.result().version);
+    EXPECT_FALSE(parser.result().verbose);
+    EXPECT_EQ(parser.result().color, "blue");
+}
+
+TEST(AbbreviationTest, Ambiguous) {
+    const char* argv[] = {"program", "--ver"};
+    slic::ArgParser<AbbreviatedOptions> parser(2, argv);
+    auto result = parser.parse();
+    EXPECT_EQ(result.error, slic::ParseError::AmbiguousOption);
+    EXPECT_EQ(result.context, "--ver");
+    EXPECT_EQ(result.argIndex, 1u);
+
+    std::string out;
+    result.print(StringSink{out});
+    EXPECT_EQ(out, "Error: Ambiguous option '--ver'\nDid you mean '--verbose' or '--version'?\n");
+}
+
+TEST(AbbreviationTest, OnlyLongNames) {
+    const char* argv[] = {"program", "-verb"};
+    slic::ArgParser<AbbreviatedOptions> parser(2, argv);
+    EXPECT_EQ(parser.parse().error, slic::ParseError::UnknownOption);
+
+    const char* unknown[] = {"program", "--size"};
+    EXPECT_EQ(parser.parse(std::span{unknown}).error, slic::ParseError::UnknownOption);
+}
+
+TEST(AbbreviationTest, OptIn) {
+    const char* argv[] = {"program", "--verb", "x"};
+    slic::ArgParser<SimpleOptions> parser(3, argv);
+    EXPECT_EQ(parser.parse().error, slic::ParseError::UnknownOption);
+}
+
+// ============================================================================
+// Config Handle Tests
+// ============================================================================
+
+TEST(ConfigHandleTest, StartsWithDefaults) {
+    slic::ConfigHandle<ServiceOptions> config;
+    EXPECT_EQ(config.read()->first, 0);
+    EXPECT_EQ(config.read()->tag, "default");
+    EXPECT_EQ(config.version(), 0u);
+}
+
+TEST(ConfigHandleTest, ReloadPublishes) {
+    slic::ConfigHandle<ServiceOptions> config;
+    std::vector<std::string> args = {"service", "--first", "1", "--tag", "blue"};
+    std::vector<char const*> argv;
+    for (auto const& arg : args) argv.push_back(arg.c_str());
+    ASSERT_TRUE(config.reload(argv).isOk());
+
+    // the handle keeps its own copy of the arguments
+    args[4] = "gone";
+    auto snapshot = config.read();
+    EXPECT_EQ(snapshot->first, 1);
+    EXPECT_EQ(snapshot->tag, "blue");
+    EXPECT_EQ(config.version(), 1u);
+}
+
+TEST(ConfigHandleTest, FailedReloadKeepsSnapshot) {
+    slic::ConfigHandle<ServiceOptions> config;
+    const char* good[] = {"service", "--first", "5"};
+    const char* bad[] = {"service", "--second", "2", "--first", "x"};
+    ASSERT_TRUE(config.reload(good).isOk());
+
+    auto result = config.reload(bad);
+    EXPECT_EQ(result.error, slic::ParseError::InvalidValue);
+    EXPECT_EQ(result.context, "--first");
+    EXPECT_EQ(config.read()->first, 5);
+    EXPECT_EQ(config.read()->second, 0);
+    EXPECT_EQ(config.version(), 1u);
+
+    const char* reset[] = {"service"};
+    ASSERT_TRUE(config.reload(reset).isOk());
+    EXPECT_EQ(config.read()->first, 0);
+}
+
+TEST_F(ConfigFileTest, HandleReloadsConfigFile) {
+    slic::ConfigHandle<ConfigFileOptions> config;
+    const char* args[] = {"program", "--mode", "fast"};
+    std::string first = write("threads = 4\nmode = slow\nname = first\n");
+    ASSERT_TRUE(config.reload(args, first.c_str(), NoEnv).isOk());
+    EXPECT_EQ(config.read()->threads, 4);
+    EXPECT_EQ(config.read()->mode, "fast");
+    EXPECT_EQ(config.read()->name, "first");
+
+    std::string second = write("threads = 8\nname = second\n");
+    ASSERT_TRUE(config.reload(args, second.c_str(), NoEnv).isOk());
+    EXPECT_EQ(config.read()->threads, 8);
+    EXPECT_EQ(config.read()->name, "second");
+    EXPECT_EQ(config.version(), 2u);
+
+    auto result = config.reload(args, (testing::TempDir() + "slic_missing.conf").c_str(), NoEnv);
+    EXPECT_EQ(result.error, slic::ParseError::InvalidConfigFile);
+    EXPECT_EQ(config.read()->name, "second");
+    EXPECT_EQ(config.version(), 2u);
+}
+
+TEST(ConfigHandleTest, ReloadRequest) {
+    slic::ConfigHandle<ServiceOptions> config;
+    EXPECT_FALSE(config.takeReloadRequest());
+    config.requestReload();
+    EXPECT_TRUE(config.takeReloadRequest());
+    EXPECT_FALSE(config.takeReloadRequest());
+}
+
+TEST(ConfigHandleTest, ReadersSeeWholeSnapshots) {
+    slic::ConfigHandle<ServiceOptions> config;
+    std::atomic<bool> done{false};
+    std::atomic<int> torn{0};
+
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 4; ++t) {
+        readers.emplace_back([&] {
+            while (!done.load()) {
+                auto snapshot = config.read();
+                if (snapshot->first != snapshot->second ||
+                    (snapshot->first != 0 && snapshot->tag != "v" + std::to_string(snapshot->first))) {
+                    ++torn;
+                }
+            }
+        });
+    }
+
+    for (int i = 1; i <= 500; ++i) {
+        auto value = std::to_string(i);
+        auto tag = "v" + value;
+        const char* argv[] = {"service", "--first", value.c_str(), "--second", value.c_str(), "--tag", tag.c_str()};
+        ASSERT_TRUE(config.reload(argv).isOk());
+    }
+    done = true;
+    for (auto& reader : readers) reader.join();
+
+    EXPECT_EQ(torn.load(), 0);
+    EXPECT_EQ(config.read()->first, 500);
+    EXPECT_EQ(config.version(), 500u);
+}
+
+// ============================================================================
+// Compact Parser Tests
+// ============================================================================
+
+struct CompactRequired {
+    std::string_view cluster;
+    int replicas = 1;
+    std::optional<std::string_view> input;
+
+    static constexpr auto Options = std::make_tuple(
+        slic::Option{"--cluster", "-c", &CompactRequired::cluster}.required(),
+        slic::Option{"--replicas", "-r", &CompactRequired::replicas},
+        slic::Arg{"input", &CompactRequired::input}
+    );
+};
+
+/// @brief Parses argv with both backends and checks that they agree on the outcome.
+template <class T>
+static slic::ParseResult parseBoth(std::vector<char const*> argv, T& out) {
+    slic::ArgParser<T> full(static_cast<int>(argv.size()), argv.data());
+    slic::CompactArgParser<T> compact(static_cast<int>(argv.size()), argv.data());
+    auto expected = full.parse();
+    auto result = compact.parse();
+    EXPECT_EQ(result.error, expected.error);
+    EXPECT_EQ(result.context, expected.context);
+    EXPECT_EQ(result.argIndex, expected.argIndex);
+    EXPECT_EQ(result.value, expected.value);
+    out = compact.result();
+    return result;
+}
+
+TEST(CompactParserTest, Options) {
+    SimpleOptions out;
+    ASSERT_TRUE(parseBoth<SimpleOptions>({"program", "-v", "--count=3", "alice"}, out).isOk());
+    EXPECT_TRUE(out.verbose);
+    EXPECT_EQ(out.count, 3);
+    EXPECT_EQ(out.name, "alice");
+
+    ASSERT_TRUE(parseBoth<SimpleOptions>({"program", "bob", "-c", "7"}, out).isOk());
+    EXPECT_FALSE(out.verbose);
+    EXPECT_EQ(out.count, 7);
+}
+
+TEST(CompactParserTest, ShortClusters) {
+    CollectOptions out;
+    ASSERT_TRUE(parseBoth<CollectOptions>({"program", "-vIa", "-l1", "-Ib", "-w=0.5"}, out).isOk());
+    EXPECT_TRUE(out.verbose);
+    ASSERT_EQ(out.includes.size(), 2u);
+    EXPECT_EQ(out.includes[1], "b");
+    EXPECT_EQ(out.levels[0], 1);
+    EXPECT_EQ(out.weights[0], 0.5);
+
+    EXPECT_EQ(parseBoth<CollectOptions>({"program", "-vx"}, out).error, slic::ParseError::UnknownOption);
+    EXPECT_EQ(parseBoth<CollectOptions>({"program", "-vI"}, out).error, slic::ParseError::MissingValue);
+    EXPECT_EQ(parseBoth<CollectOptions>({"program", "-l", "1", "-l2", "-l3"}, out).error, slic::ParseError::TooManyValues);
+}
+
+TEST(CompactParserTest, Errors) {
+    NumericOptions out;
+    EXPECT_EQ(parseBoth<NumericOptions>({"program", "--int"}, out).error, slic::ParseError::MissingValue);
+    EXPECT_EQ(parseBoth<NumericOptions>({"program", "-i", "1", "--float", "x"}, out).error, slic::ParseError::InvalidValue);
+    EXPECT_EQ(parseBoth<NumericOptions>({"program", "stray"}, out).error, slic::ParseError::TooManyArgs);
+
+    auto unknown = parseBoth<NumericOptions>({"program", "--doubel=2"}, out);
+    EXPECT_EQ(unknown.error, slic::ParseError::UnknownOption);
+    ASSERT_EQ(unknown.suggestions().size(), 1u);
+    EXPECT_EQ(unknown.suggestions()[0], "--double");
+
+    SimpleOptions simple;
+    EXPECT_EQ(parseBoth<SimpleOptions>({"program", "-v"}, simple).error, slic::ParseError::MissingRequiredArg);
+    EXPECT_EQ(parseBoth<SimpleOptions>({"program", "--verbose=maybe", "x"}, simple).error, slic::ParseError::InvalidValue);
+}
+
+TEST(CompactParserTest, VarArgs) {
+    VarArgsOptions out;
+    ASSERT_TRUE(parseBoth<VarArgsOptions>({"program", "run", "a", "-b"}, out).isOk());
+    EXPECT_EQ(out.command, "run");
+    ASSERT_EQ(out.args.size(), 2u);
+    EXPECT_EQ(out.args[1], std::string_view("-b"));
+
+    ASSERT_TRUE(parseBoth<VarArgsOptions>({"program", "run", "--", "--x"}, out).isOk());
+    ASSERT_EQ(out.args.size(), 1u);
+    EXPECT_EQ(out.args[0], std::string_view("--x"));
+}
+
+TEST(CompactParserTest, Required) {
+    CompactRequired out;
+    ASSERT_TRUE(parseBoth<CompactRequired>({"program", "-c", "prod"}, out).isOk());
+    EXPECT_EQ(out.cluster, "prod");
+    EXPECT_FALSE(out.input.has_value());
+
+    auto result = parseBoth<CompactRequired>({"program", "-r", "2", "in"}, out);
+    EXPECT_EQ(result.error, slic::ParseError::MissingRequiredOption);
+    EXPECT_EQ(result.context, "--cluster");
+}
+
+TEST(CompactParserTest, Abbreviations) {
+    AbbreviatedOptions out;
+    ASSERT_TRUE(parseBoth<AbbreviatedOptions>({"program", "--verb", "--cou=3", "--col", "red"}, out).isOk());
+    EXPECT_TRUE(out.verbose);
+    EXPECT_EQ(out.count, 3);
+    EXPECT_EQ(out.color, "red");
+
+    auto ambiguous = parseBoth<AbbreviatedOptions>({"program", "--ver"}, out);
+    EXPECT_EQ(ambiguous.error, slic::ParseError::AmbiguousOption);
+    EXPECT_EQ(ambiguous.suggestions().size(), 2u);
+}
+
+struct CompactConstrained {
+    int threads = 4;
+    std::string_view format = "json";
+    std::optional<unsigned> port;
+
+    static constexpr auto Options = std::make_tuple(
+        slic::Option{"--threads", "-t", &CompactConstrained::threads}.range(1, 256),
+        slic::Option{"--format", &CompactConstrained::format}.oneOf({"json", "yaml"}),
+        slic::Arg{"port", &CompactConstrained::port}.max(65535u)
+    );
+};
+
+TEST(CompactParserTest, Constraints) {
+    CompactConstrained out;
+    ASSERT_TRUE(parseBoth<CompactConstrained>({"program", "-t", "8", "--format=yaml", "443"}, out).isOk());
+    EXPECT_EQ(out.threads, 8);
+    EXPECT_EQ(out.format, "yaml");
+    EXPECT_EQ(out.port, 443u);
+
+    EXPECT_EQ(parseBoth<CompactConstrained>({"program", "-t", "300"}, out).context, "--threads [range: 1..256]");
+    EXPECT_EQ(parseBoth<CompactConstrained>({"program", "--format", "xml"}, out).context, "--format [one of: json, yaml]");
+    EXPECT_EQ(parseBoth<CompactConstrained>({"program", "70000"}, out).context, "port [max: 65535]");
+    EXPECT_EQ(parseBoth<CompactConstrained>({"program", "-t", "x"}, out).context, "-t");
+}
+
+TEST(CompactParserTest, Reuse) {
+    const char* first[] = {"program", "-v", "-c", "3", "a"};
+    const char* second[] = {"other", "b"};
+    slic::CompactArgParser<SimpleOptions> parser;
+    ASSERT_TRUE(parser.parse(std::span{first}).isOk());
+    ASSERT_TRUE(parser.parse(std::span{second}).isOk());
+    EXPECT_FALSE(parser.result().verbose);
+    EXPECT_EQ(parser.result().count, 0);
+    EXPECT_EQ(parser.result().name, "b");
+    EXPECT_EQ(parser.programName(), "other");
+
+    std::string_view tokens[8];
+    char scratch[64];
+    slic::Tokenizer tokenizer(tokens, scratch);
+    ASSERT_TRUE(parser.parseString("tool -c 5 'x y'", tokenizer).isOk());
+    EXPECT_EQ(parser.result().count, 5);
+    EXPECT_EQ(parser.result().name, "x y");
 }
 
 // ============================================================================